@@ -17,6 +17,7 @@
 
 /**
  * Convenience block callback for developers lazy to implement the MGSwipeTableCellDelegate.
+ * cell is the swiped cell. Buttons shared through MGSwipeButtonsPool are reused by other rows, get the row from cell instead of capturing it.
  * @return Return YES to autohide the swipe view
  */
 typedef BOOL(^ MGSwipeButtonCallback)(MGSwipeTableCell * _Nonnull cell);
@@ -49,3 +50,83 @@ typedef BOOL(^ MGSwipeButtonCallback)(MGSwipeTableCell * _Nonnull cell);
 
 
 @end
+
+
+/**
+ * Lightweight layer backed swipe button.
+ * It has no title label or image view, the icon and title are drawn once into a bitmap shared by all the buttons
+ * with the same contents (see MGSwipeButtonImageCache). Showing the same action on any row costs no text layout or drawing.
+ */
+@interface MGSwipeRenderedButton : UIControl
+
+@property (nonatomic, copy, readonly, nonnull) NSString * title;
+@property (nonatomic, strong, readonly, nullable) UIImage * icon;
+/** Title color. Default value white */
+@property (nonatomic, strong, nonnull) UIColor * titleColor;
+/** Insets around the icon and title, the contents are centered in the remaining space */
+@property (nonatomic, assign) UIEdgeInsets edgeInsets;
+@property (nonatomic, strong, nullable) MGSwipeButtonCallback callback;
+
++(nonnull instancetype) buttonWithTitle:(nonnull NSString *) title icon:(nullable UIImage*) icon backgroundColor:(nullable UIColor *) color insets:(UIEdgeInsets) insets callback:(nullable MGSwipeButtonCallback) callback;
+
+@end
+
+
+/**
+ * Bitmap cache shared by all the MGSwipeRenderedButton instances.
+ * Bitmaps are keyed by title, icon, colors, size and scale and evicted in least recently used order above memoryLimit.
+ * Dynamic colors are resolved for the trait collection of each button, which renders again when its appearance changes.
+ */
+@interface MGSwipeButtonImageCache : NSObject
+
++(nonnull instancetype) sharedCache;
+/** Maximum bytes used by the cached bitmaps. Default value 4MB */
+@property (nonatomic, assign) NSUInteger memoryLimit;
+/** Bytes currently used by the cached bitmaps */
+@property (nonatomic, readonly) NSUInteger memoryUsage;
+@property (nonatomic, readonly) NSUInteger count;
+/** Number of lookups that found a cached bitmap */
+@property (nonatomic, readonly) NSUInteger hits;
+/** Number of lookups that had to render a new bitmap */
+@property (nonatomic, readonly) NSUInteger misses;
+/** hits / (hits + misses), 0 before the first lookup */
+@property (nonatomic, readonly) double hitRate;
+
+-(void) removeAllImages;
+-(void) resetCounters;
+
+@end
+
+
+/**
+ * Lightweight immutable description of a MGSwipeButton.
+ * Descriptors can be measured on a background queue and are only turned into buttons when the swipe starts,
+ * so returning them from the MGSwipeTableCellDelegate keeps button creation and text layout out of the gesture path.
+ */
+@interface MGSwipeButtonDescriptor : NSObject <NSCopying>
+
+@property (nonatomic, copy, readonly, nonnull) NSString * title;
+@property (nonatomic, strong, readonly, nullable) UIImage * icon;
+@property (nonatomic, strong, readonly, nullable) UIColor * backgroundColor;
+@property (nonatomic, readonly) UIEdgeInsets insets;
+/** Fixed button width. 0 means the width is measured from the title and icon */
+@property (nonatomic, readonly) CGFloat buttonWidth;
+@property (nonatomic, strong, readonly, nullable) MGSwipeButtonCallback callback;
+/** Button size. Measured on first access (or by prefetchDescriptors:) and cached among equal descriptors */
+@property (nonatomic, readonly) CGSize measuredSize;
+
++(nonnull instancetype) descriptorWithTitle:(nonnull NSString *) title icon:(nullable UIImage*) icon backgroundColor:(nullable UIColor *) color callback:(nullable MGSwipeButtonCallback) callback;
++(nonnull instancetype) descriptorWithTitle:(nonnull NSString *) title icon:(nullable UIImage*) icon backgroundColor:(nullable UIColor *) color insets:(UIEdgeInsets) insets buttonWidth:(CGFloat) buttonWidth callback:(nullable MGSwipeButtonCallback) callback;
+
+/**
+ * Measures the descriptors on a background queue.
+ * Call it from tableView:prefetchRowsAtIndexPaths: so upcoming rows are measured before the user touches them
+ */
++(void) prefetchDescriptors:(nonnull NSArray<MGSwipeButtonDescriptor *> *) descriptors;
+
+/** Creates the button using the measured size, without additional text layout */
+-(nonnull MGSwipeButton *) button;
+/** Creates a MGSwipeRenderedButton using the measured size. Its contents are drawn from the shared MGSwipeButtonImageCache */
+-(nonnull MGSwipeRenderedButton *) renderedButton;
+
+@end
@@ -7,6 +7,57 @@
 
 @class MGSwipeTableCell;
 
+#pragma mark Content measurement
+
+static UIFont * mgSwipeButtonTitleFont(void)
+{
+    return [UIFont systemFontOfSize:15]; //UIButton default title font
+}
+
+static NSCache * mgSwipeButtonMeasurementCache(void)
+{
+    static NSCache * cache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [[NSCache alloc] init];
+        cache.countLimit = 256;
+    });
+    return cache;
+}
+
+/** Cached content size. Retains the icon so its address, used in the key, can't be reused by another image while cached */
+@interface MGSwipeButtonMeasurement : NSObject
+{
+    @public
+    UIImage * _icon;
+    CGSize _size;
+}
+@end
+
+@implementation MGSwipeButtonMeasurement
+@end
+
+/** Size of the icon and title without insets. Thread safe, cached among buttons with the same contents */
+static CGSize mgSwipeButtonContentSize(NSString * title, UIImage * icon)
+{
+    NSString * key = [NSString stringWithFormat:@"%@|%p", title, icon];
+    MGSwipeButtonMeasurement * cached = [mgSwipeButtonMeasurementCache() objectForKey:key];
+    if (cached && cached->_icon == icon) {
+        return cached->_size;
+    }
+    CGSize textSize = [title boundingRectWithSize:CGSizeMake(CGFLOAT_MAX, CGFLOAT_MAX)
+                                          options:NSStringDrawingUsesLineFragmentOrigin
+                                       attributes:@{NSFontAttributeName: mgSwipeButtonTitleFont()}
+                                          context:nil].size;
+    CGSize iconSize = icon.size;
+    CGSize size = CGSizeMake(ceil(textSize.width + iconSize.width), ceil(MAX(textSize.height, iconSize.height)));
+    MGSwipeButtonMeasurement * measurement = [[MGSwipeButtonMeasurement alloc] init];
+    measurement->_icon = icon;
+    measurement->_size = size;
+    [mgSwipeButtonMeasurementCache() setObject:measurement forKey:key];
+    return size;
+}
+
 @implementation MGSwipeButton
 
 +(instancetype) buttonWithTitle:(NSString *) title backgroundColor:(UIColor *) color
@@ -179,3 +230,407 @@
 }
 
 @end
+
+#pragma mark MGSwipeButtonImageCache
+
+@interface MGSwipeButtonImageCacheEntry : NSObject
+{
+    @public
+    NSString * _key;
+    UIImage * _image;
+    UIImage * _icon; //keeps the icon address used in the key alive
+    NSUInteger _cost;
+    __unsafe_unretained MGSwipeButtonImageCacheEntry * _previous; //entries are owned by the dictionary
+    __unsafe_unretained MGSwipeButtonImageCacheEntry * _next;
+}
+@end
+
+@implementation MGSwipeButtonImageCacheEntry
+@end
+
+@interface MGSwipeButtonImageCache ()
+-(UIImage *) imageForTitle:(NSString *) title icon:(UIImage *) icon titleColor:(UIColor *) titleColor
+           backgroundColor:(UIColor *) backgroundColor size:(CGSize) size scale:(CGFloat) scale;
+@end
+
+@implementation MGSwipeButtonImageCache
+{
+    NSMutableDictionary<NSString *, MGSwipeButtonImageCacheEntry *> * _entries;
+    //most recently used first
+    __unsafe_unretained MGSwipeButtonImageCacheEntry * _head;
+    __unsafe_unretained MGSwipeButtonImageCacheEntry * _tail;
+}
+
++(instancetype) sharedCache
+{
+    static MGSwipeButtonImageCache * cache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        cache = [[MGSwipeButtonImageCache alloc] init];
+    });
+    return cache;
+}
+
+-(instancetype) init
+{
+    if (self = [super init]) {
+        _entries = [NSMutableDictionary dictionary];
+        _memoryLimit = 4 * 1024 * 1024;
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(removeAllImages) name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+    }
+    return self;
+}
+
+-(void) dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+-(NSUInteger) count
+{
+    @synchronized (self) {
+        return _entries.count;
+    }
+}
+
+-(double) hitRate
+{
+    @synchronized (self) {
+        NSUInteger lookups = _hits + _misses;
+        return lookups ? (double) _hits / lookups : 0;
+    }
+}
+
+-(void) setMemoryLimit:(NSUInteger) memoryLimit
+{
+    @synchronized (self) {
+        _memoryLimit = memoryLimit;
+        [self evictToLimit];
+    }
+}
+
+-(void) removeAllImages
+{
+    @synchronized (self) {
+        _head = _tail = nil;
+        [_entries removeAllObjects];
+        _memoryUsage = 0;
+    }
+}
+
+-(void) resetCounters
+{
+    @synchronized (self) {
+        _hits = _misses = 0;
+    }
+}
+
+-(void) unlink:(MGSwipeButtonImageCacheEntry *) entry
+{
+    if (entry->_previous) entry->_previous->_next = entry->_next;
+    if (entry->_next) entry->_next->_previous = entry->_previous;
+    if (_head == entry) _head = entry->_next;
+    if (_tail == entry) _tail = entry->_previous;
+    entry->_previous = entry->_next = nil;
+}
+
+-(void) pushFront:(MGSwipeButtonImageCacheEntry *) entry
+{
+    entry->_next = _head;
+    if (_head) _head->_previous = entry;
+    _head = entry;
+    if (!_tail) _tail = entry;
+}
+
+-(void) evictToLimit
+{
+    while (_memoryUsage > _memoryLimit && _tail) {
+        MGSwipeButtonImageCacheEntry * entry = _tail;
+        [self unlink:entry];
+        _memoryUsage -= entry->_cost;
+        [_entries removeObjectForKey:entry->_key];
+    }
+}
+
+-(UIImage *) renderTitle:(NSString *) title icon:(UIImage *) icon titleColor:(UIColor *) titleColor
+         backgroundColor:(UIColor *) backgroundColor size:(CGSize) size scale:(CGFloat) scale
+{
+    BOOL opaque = backgroundColor && CGColorGetAlpha(backgroundColor.CGColor) >= 1.0;
+    UIGraphicsBeginImageContextWithOptions(size, opaque, scale);
+    if (opaque) {
+        //opaque bitmaps are composited without blending
+        [backgroundColor setFill];
+        UIRectFill(CGRectMake(0, 0, size.width, size.height));
+    }
+    CGSize iconSize = icon.size;
+    CGFloat textWidth = size.width - iconSize.width;
+    if (icon) {
+        [icon drawInRect:CGRectMake(0, (size.height - iconSize.height) * 0.5, iconSize.width, iconSize.height)];
+    }
+    if (title.length > 0) {
+        NSMutableParagraphStyle * style = [[NSMutableParagraphStyle alloc] init];
+        style.alignment = NSTextAlignmentCenter;
+        style.lineBreakMode = NSLineBreakByWordWrapping;
+        NSDictionary * attributes = @{NSFontAttributeName: mgSwipeButtonTitleFont(), NSForegroundColorAttributeName: titleColor, NSParagraphStyleAttributeName: style};
+        CGRect textRect = [title boundingRectWithSize:CGSizeMake(textWidth, CGFLOAT_MAX) options:NSStringDrawingUsesLineFragmentOrigin attributes:attributes context:nil];
+        textRect = CGRectMake(iconSize.width, (size.height - textRect.size.height) * 0.5, textWidth, ceil(textRect.size.height));
+        [title drawWithRect:textRect options:NSStringDrawingUsesLineFragmentOrigin attributes:attributes context:nil];
+    }
+    UIImage * image = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+    return image;
+}
+
+-(UIImage *) imageForTitle:(NSString *) title icon:(UIImage *) icon titleColor:(UIColor *) titleColor
+           backgroundColor:(UIColor *) backgroundColor size:(CGSize) size scale:(CGFloat) scale
+{
+    if (size.width <= 0 || size.height <= 0) {
+        return nil;
+    }
+    NSString * key = [NSString stringWithFormat:@"%@|%p|%@|%@|%@|%g", title, icon, titleColor, backgroundColor, NSStringFromCGSize(size), scale];
+    @synchronized (self) {
+        MGSwipeButtonImageCacheEntry * entry = [_entries objectForKey:key];
+        if (entry) {
+            _hits++;
+            [self unlink:entry];
+            [self pushFront:entry];
+            return entry->_image;
+        }
+        _misses++;
+    }
+    UIImage * image = [self renderTitle:title icon:icon titleColor:titleColor backgroundColor:backgroundColor size:size scale:scale];
+    @synchronized (self) {
+        if ([_entries objectForKey:key]) {
+            return image; //rendered concurrently, keep the first one
+        }
+        MGSwipeButtonImageCacheEntry * entry = [[MGSwipeButtonImageCacheEntry alloc] init];
+        entry->_key = key;
+        entry->_image = image;
+        entry->_icon = icon;
+        entry->_cost = (NSUInteger) (ceil(size.width * scale) * ceil(size.height * scale) * 4);
+        [_entries setObject:entry forKey:key];
+        [self pushFront:entry];
+        _memoryUsage += entry->_cost;
+        [self evictToLimit];
+    }
+    return image;
+}
+
+@end
+
+#pragma mark MGSwipeRenderedButton
+
+@implementation MGSwipeRenderedButton
+{
+    CALayer * _contentLayer;
+    CGSize _contentSize;
+}
+
++(instancetype) buttonWithTitle:(NSString *) title icon:(UIImage*) icon backgroundColor:(UIColor *) color insets:(UIEdgeInsets) insets callback:(MGSwipeButtonCallback) callback
+{
+    MGSwipeRenderedButton * button = [[self alloc] initWithTitle:title icon:icon];
+    button.backgroundColor = color;
+    button.callback = callback;
+    button.edgeInsets = insets;
+    [button sizeToFit];
+    return button;
+}
+
+-(instancetype) initWithTitle:(NSString *) title icon:(UIImage *) icon
+{
+    if (self = [super initWithFrame:CGRectZero]) {
+        _title = [title copy];
+        _icon = icon;
+        _titleColor = [UIColor whiteColor];
+        _contentSize = mgSwipeButtonContentSize(_title, _icon);
+        _contentLayer = [CALayer layer];
+        _contentLayer.actions = @{@"contents": [NSNull null], @"bounds": [NSNull null], @"position": [NSNull null]};
+        _contentLayer.contentsScale = [UIScreen mainScreen].scale;
+        [self.layer addSublayer:_contentLayer];
+        self.isAccessibilityElement = YES;
+        self.accessibilityLabel = _title;
+        self.accessibilityTraits = UIAccessibilityTraitButton;
+    }
+    return self;
+}
+
+-(void) updateContents
+{
+    CGFloat scale = self.window ? self.window.screen.scale : [UIScreen mainScreen].scale;
+    UIColor * titleColor = _titleColor;
+    UIColor * backgroundColor = self.backgroundColor;
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 130000
+    if (@available(iOS 13, *)) {
+        //the bitmap doesn't follow dynamic colors, draw and key it with the colors of the current appearance
+        UITraitCollection * traits = self.traitCollection;
+        titleColor = [titleColor resolvedColorWithTraitCollection:traits];
+        backgroundColor = [backgroundColor resolvedColorWithTraitCollection:traits];
+    }
+#endif
+    UIImage * image = [[MGSwipeButtonImageCache sharedCache] imageForTitle:_title icon:_icon titleColor:titleColor
+                                                           backgroundColor:backgroundColor size:_contentSize scale:scale];
+    _contentLayer.contents = (__bridge id) image.CGImage;
+    _contentLayer.contentsScale = scale;
+}
+
+-(void) setBackgroundColor:(UIColor *) backgroundColor
+{
+    [super setBackgroundColor:backgroundColor];
+    [self updateContents]; //the bitmap is opaque when the background is
+}
+
+-(void) setTitleColor:(UIColor *) titleColor
+{
+    _titleColor = titleColor;
+    [self updateContents];
+}
+
+-(void) setEdgeInsets:(UIEdgeInsets) edgeInsets
+{
+    _edgeInsets = edgeInsets;
+    [self setNeedsLayout];
+}
+
+-(void) didMoveToWindow
+{
+    [super didMoveToWindow];
+    if (self.window && self.window.screen.scale != _contentLayer.contentsScale) {
+        [self updateContents];
+    }
+}
+
+-(void) traitCollectionDidChange:(UITraitCollection *) previousTraitCollection
+{
+    [super traitCollectionDidChange:previousTraitCollection];
+#if __IPHONE_OS_VERSION_MAX_ALLOWED >= 130000
+    if (@available(iOS 13, *)) {
+        if ([self.traitCollection hasDifferentColorAppearanceComparedToTraitCollection:previousTraitCollection]) {
+            [self updateContents];
+        }
+    }
+#endif
+}
+
+-(CGSize) sizeThatFits:(CGSize) size
+{
+    return CGSizeMake(_contentSize.width + _edgeInsets.left + _edgeInsets.right, _contentSize.height + _edgeInsets.top + _edgeInsets.bottom);
+}
+
+-(void) layoutSubviews
+{
+    [super layoutSubviews];
+    //only moves the shared bitmap, no text layout
+    CGRect rect = UIEdgeInsetsInsetRect(self.bounds, _edgeInsets);
+    CGFloat scale = _contentLayer.contentsScale;
+    _contentLayer.frame = CGRectMake(round((CGRectGetMidX(rect) - _contentSize.width * 0.5) * scale) / scale,
+                                     round((CGRectGetMidY(rect) - _contentSize.height * 0.5) * scale) / scale,
+                                     _contentSize.width, _contentSize.height);
+}
+
+-(void) setHighlighted:(BOOL) highlighted
+{
+    [super setHighlighted:highlighted];
+    _contentLayer.opacity = highlighted ? 0.5 : 1.0;
+}
+
+-(BOOL) callMGSwipeConvenienceCallback: (MGSwipeTableCell *) sender
+{
+    if (_callback) {
+        return _callback(sender);
+    }
+    return NO;
+}
+
+@end
+
+#pragma mark MGSwipeButtonDescriptor
+
+@implementation MGSwipeButtonDescriptor
+{
+    BOOL _measured;
+}
+
++(instancetype) descriptorWithTitle:(NSString *) title icon:(UIImage*) icon backgroundColor:(UIColor *) color callback:(MGSwipeButtonCallback) callback
+{
+    return [self descriptorWithTitle:title icon:icon backgroundColor:color insets:UIEdgeInsetsMake(0, 10, 0, 10) buttonWidth:0 callback:callback];
+}
+
++(instancetype) descriptorWithTitle:(NSString *) title icon:(UIImage*) icon backgroundColor:(UIColor *) color insets:(UIEdgeInsets) insets buttonWidth:(CGFloat) buttonWidth callback:(MGSwipeButtonCallback) callback
+{
+    MGSwipeButtonDescriptor * descriptor = [[self alloc] init];
+    descriptor->_title = [title copy];
+    descriptor->_icon = icon;
+    descriptor->_backgroundColor = color;
+    descriptor->_insets = insets;
+    descriptor->_buttonWidth = buttonWidth;
+    descriptor->_callback = callback;
+    return descriptor;
+}
+
+-(id) copyWithZone:(NSZone *) zone
+{
+    return self; //immutable
+}
+
++(dispatch_queue_t) measurementQueue
+{
+    static dispatch_queue_t queue = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("mgswipe.button.measurement", DISPATCH_QUEUE_SERIAL);
+    });
+    return queue;
+}
+
+-(CGSize) measuredSize
+{
+    @synchronized (self) {
+        if (_measured) {
+            return _measuredSize;
+        }
+        //string measurement is thread safe, so this can run on the measurement queue
+        CGSize contentSize = mgSwipeButtonContentSize(_title, _icon);
+        _measuredSize = CGSizeMake(_buttonWidth > 0 ? _buttonWidth : contentSize.width + _insets.left + _insets.right,
+                                   contentSize.height + _insets.top + _insets.bottom);
+        _measured = YES;
+        return _measuredSize;
+    }
+}
+
++(void) prefetchDescriptors:(NSArray<MGSwipeButtonDescriptor *> *) descriptors
+{
+    NSArray * copy = [descriptors copy];
+    dispatch_async([self measurementQueue], ^{
+        for (MGSwipeButtonDescriptor * descriptor in copy) {
+            [descriptor measuredSize];
+        }
+    });
+}
+
+-(MGSwipeButton *) button
+{
+    MGSwipeButton * button = [MGSwipeButton buttonWithType:UIButtonTypeCustom];
+    button.backgroundColor = _backgroundColor;
+    button.titleLabel.lineBreakMode = NSLineBreakByWordWrapping;
+    button.titleLabel.textAlignment = NSTextAlignmentCenter;
+    button.titleLabel.font = mgSwipeButtonTitleFont();
+    [button setTitle:_title forState:UIControlStateNormal];
+    [button setTitleColor:[UIColor whiteColor] forState:UIControlStateNormal];
+    [button setImage:_icon forState:UIControlStateNormal];
+    button.callback = _callback;
+    //set the insets directly, the measured size replaces the sizeToFit done by setEdgeInsets:
+    button.contentEdgeInsets = _insets;
+    CGSize size = self.measuredSize;
+    button.frame = CGRectMake(0, 0, size.width, size.height);
+    return button;
+}
+
+-(MGSwipeRenderedButton *) renderedButton
+{
+    MGSwipeRenderedButton * button = [MGSwipeRenderedButton buttonWithTitle:_title icon:_icon backgroundColor:_backgroundColor insets:_insets callback:_callback];
+    CGSize size = self.measuredSize;
+    button.frame = CGRectMake(0, 0, size.width, size.height);
+    return button;
+}
+
+@end
@@ -0,0 +1,1205 @@
+/*
+ * MGSwipeTableCell is licensed under MIT license. See LICENSE.md file for more information.
+ * Copyright (c) 2016 Imanol Fernandez @MortimerGoro
+ */
+
+/**
+ * UIKit independent core of MGSwipeTableCell.
+ * Plain C so it can be compiled, tested and benchmarked on any platform without UIKit.
+ */
+
+#ifndef MGSwipeCore_h
+#define MGSwipeCore_h
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __cplusplus
+/* C11 atomics names for C++ sources, like the C++23 <stdatomic.h> */
+#include <atomic>
+using std::atomic_size_t;
+using std::atomic_init;
+using std::atomic_load_explicit;
+using std::atomic_store_explicit;
+using std::atomic_fetch_add_explicit;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
+#else
+#include <stdatomic.h>
+#endif
+
+/* Easing Functions */
+
+/** Easing function. t is the normalized time [0, 1], b the start value and c the change in value */
+typedef double (*MGEasingFunction)(double t, double b, double c);
+
+static inline double mgEaseLinear(double t, double b, double c) {
+    return c*t + b;
+}
+
+static inline double mgEaseInQuad(double t, double b, double c) {
+    return c*t*t + b;
+}
+static inline double mgEaseOutQuad(double t, double b, double c) {
+    return -c*t*(t-2) + b;
+}
+static inline double mgEaseInOutQuad(double t, double b, double c) {
+    if ((t*=2) < 1) return c/2*t*t + b;
+    --t;
+    return -c/2 * (t*(t-2) - 1) + b;
+}
+static inline double mgEaseInCubic(double t, double b, double c) {
+    return c*t*t*t + b;
+}
+static inline double mgEaseOutCubic(double t, double b, double c) {
+    --t;
+    return c*(t*t*t + 1) + b;
+}
+static inline double mgEaseInOutCubic(double t, double b, double c) {
+    if ((t*=2) < 1) return c/2*t*t*t + b;
+    t-=2;
+    return c/2*(t*t*t + 2) + b;
+}
+static inline double mgEaseOutBounce(double t, double b, double c) {
+    if (t < (1/2.75)) {
+        return c*(7.5625*t*t) + b;
+    } else if (t < (2/2.75)) {
+        t-=(1.5/2.75);
+        return c*(7.5625*t*t + .75) + b;
+    } else if (t < (2.5/2.75)) {
+        t-=(2.25/2.75);
+        return c*(7.5625*t*t + .9375) + b;
+    } else {
+        t-=(2.625/2.75);
+        return c*(7.5625*t*t + .984375) + b;
+    }
+}
+static inline double mgEaseInBounce(double t, double b, double c) {
+    return c - mgEaseOutBounce (1.0 -t, 0, c) + b;
+}
+
+static inline double mgEaseInOutBounce(double t, double b, double c) {
+    if (t < 0.5) return mgEaseInBounce (t*2, 0, c) * .5 + b;
+    return mgEaseOutBounce (t*2 - 1.0, 0, c) * .5 + c*.5 + b;
+}
+
+/* Easing Curves */
+
+/** Number of samples of the precomputed curves (cubic bezier and spring) */
+#define MG_EASING_TABLE_SIZE 128
+
+/** Analytic curves evaluated by the batch API without calling the function, so the loops can be vectorized */
+typedef enum MGEasingKind {
+    MGEasingKindFunction = 0, /* any other function, called per value */
+    MGEasingKindLinear,
+    MGEasingKindInQuad,
+    MGEasingKindOutQuad,
+    MGEasingKindInOutQuad,
+    MGEasingKindInCubic,
+    MGEasingKindOutCubic,
+    MGEasingKindInOutCubic
+} MGEasingKind;
+
+/**
+ * Easing curve resolved once when the animation is configured.
+ * Analytic curves use the function pointer, cubic bezier and spring curves a precomputed lookup table.
+ */
+typedef struct MGEasingCurve {
+    MGEasingFunction function;
+    double * table; /* MG_EASING_TABLE_SIZE + 1 progress samples, NULL for analytic curves */
+    MGEasingKind kind;
+} MGEasingCurve;
+
+static inline void mgEasingCurveFree(MGEasingCurve * curve) {
+    free(curve->table);
+    curve->table = NULL;
+}
+
+static inline void mgEasingCurveSetFunction(MGEasingCurve * curve, MGEasingFunction function) {
+    mgEasingCurveFree(curve);
+    curve->function = function;
+    curve->kind = function == mgEaseLinear ? MGEasingKindLinear :
+                  function == mgEaseInQuad ? MGEasingKindInQuad :
+                  function == mgEaseOutQuad ? MGEasingKindOutQuad :
+                  function == mgEaseInOutQuad ? MGEasingKindInOutQuad :
+                  function == mgEaseInCubic ? MGEasingKindInCubic :
+                  function == mgEaseOutCubic ? MGEasingKindOutCubic :
+                  function == mgEaseInOutCubic ? MGEasingKindInOutCubic : MGEasingKindFunction;
+}
+
+static inline double mgCubicBezierComponent(double s, double p1, double p2) {
+    const double u = 1.0 - s;
+    return 3.0*u*u*s*p1 + 3.0*u*s*s*p2 + s*s*s;
+}
+
+/** CSS like cubic bezier curve from (0,0) to (1,1) with control points (x1,y1) and (x2,y2) */
+static inline void mgEasingCurveSetCubicBezier(MGEasingCurve * curve, double x1, double y1, double x2, double y2) {
+    mgEasingCurveFree(curve);
+    curve->function = NULL;
+    curve->kind = MGEasingKindFunction;
+    curve->table = (double *) malloc(sizeof(double) * (MG_EASING_TABLE_SIZE + 1));
+    if (!curve->table) {
+        mgEasingCurveSetFunction(curve, mgEaseInOutCubic); // closest analytic curve, without table
+        return;
+    }
+    x1 = fmin(fmax(x1, 0.0), 1.0); // x must be monotonic to be invertible
+    x2 = fmin(fmax(x2, 0.0), 1.0);
+    for (int i = 0; i <= MG_EASING_TABLE_SIZE; ++i) {
+        const double x = (double) i / MG_EASING_TABLE_SIZE;
+        // solve bezierX(s) = x with bisection, it's only done once per curve
+        double lo = 0.0, hi = 1.0, s = x;
+        for (int j = 0; j < 32; ++j) {
+            s = (lo + hi) * 0.5;
+            if (mgCubicBezierComponent(s, x1, x2) < x) lo = s; else hi = s;
+        }
+        curve->table[i] = mgCubicBezierComponent(s, y1, y2);
+    }
+    curve->table[0] = 0.0;
+    curve->table[MG_EASING_TABLE_SIZE] = 1.0;
+}
+
+/**
+ * Damped spring normalized to settle within the animation duration.
+ * damping is the damping ratio (0, 1], 1 is critically damped. velocity is the initial velocity in distance units per duration.
+ */
+static inline void mgEasingCurveSetSpring(MGEasingCurve * curve, double damping, double velocity) {
+    mgEasingCurveFree(curve);
+    curve->function = NULL;
+    curve->kind = MGEasingKindFunction;
+    curve->table = (double *) malloc(sizeof(double) * (MG_EASING_TABLE_SIZE + 1));
+    if (!curve->table) {
+        mgEasingCurveSetFunction(curve, mgEaseOutCubic); // settles without the overshoot
+        return;
+    }
+    const double zeta = fmin(fmax(damping, 0.05), 1.0);
+    const double omega = 9.21 / zeta; // envelope decays to 0.01% at t = 1
+    for (int i = 0; i <= MG_EASING_TABLE_SIZE; ++i) {
+        const double t = (double) i / MG_EASING_TABLE_SIZE;
+        const double envelope = exp(-zeta * omega * t);
+        if (zeta >= 1.0) {
+            curve->table[i] = 1.0 - envelope * (1.0 + (omega - velocity) * t);
+        }
+        else {
+            const double omegaD = omega * sqrt(1.0 - zeta * zeta);
+            curve->table[i] = 1.0 - envelope * (cos(omegaD * t) + ((zeta * omega - velocity) / omegaD) * sin(omegaD * t));
+        }
+    }
+    curve->table[MG_EASING_TABLE_SIZE] = 1.0;
+}
+
+/** Copies source into curve, the copy owns its own lookup table */
+static inline void mgEasingCurveCopy(MGEasingCurve * curve, const MGEasingCurve * source) {
+    mgEasingCurveFree(curve);
+    *curve = *source;
+    if (!source->table) {
+        return;
+    }
+    curve->table = (double *) malloc(sizeof(double) * (MG_EASING_TABLE_SIZE + 1));
+    if (!curve->table) {
+        mgEasingCurveSetFunction(curve, mgEaseOutCubic);
+        return;
+    }
+    memcpy(curve->table, source->table, sizeof(double) * (MG_EASING_TABLE_SIZE + 1));
+}
+
+/** Progress of the curve at the normalized time t [0, 1] */
+static inline double mgEasingCurveProgress(const MGEasingCurve * curve, double t) {
+    if (!curve->table) {
+        return curve->function(t, 0.0, 1.0);
+    }
+    const double position = fmin(fmax(t, 0.0), 1.0) * MG_EASING_TABLE_SIZE;
+    const int index = position >= MG_EASING_TABLE_SIZE ? MG_EASING_TABLE_SIZE - 1 : (int) position;
+    const double fraction = position - index;
+    return curve->table[index] + (curve->table[index + 1] - curve->table[index]) * fraction;
+}
+
+static inline double mgEasingCurveValue(const MGEasingCurve * curve, double elapsed, double duration, double from, double to) {
+    const double t = fmin(elapsed / duration, 1.0);
+    if (t == 1.0) {
+        return to; //precise last value
+    }
+    if (!curve->table) {
+        return curve->function(t, from, to - from);
+    }
+    return from + (to - from) * mgEasingCurveProgress(curve, t);
+}
+
+/**
+ * Evaluates count (elapsed, from, to) triples sharing the same duration, with the same results as mgEasingCurveValue.
+ * The curve is dispatched once per batch: the lookup tables and the polynomial curves run branch free loops
+ * without calls that the compiler can vectorize. Only the bounce curves call their function per value.
+ * values must not overlap the input arrays.
+ */
+static inline void mgEasingCurveValues(const MGEasingCurve * curve, const double * __restrict elapsed, const double * __restrict from,
+                                       const double * __restrict to, double * __restrict values, size_t count, double duration) {
+    /* selects instead of fmin, fmax and branches, both sides are computed so the loops are if-converted */
+    const double invDuration = 1.0 / duration;
+    for (size_t i = 0; i < count; ++i) {
+        const double t = elapsed[i] * invDuration;
+        values[i] = t < 1.0 ? t : 1.0;
+    }
+    if (curve->table) {
+        const double * __restrict table = curve->table;
+        for (size_t i = 0; i < count; ++i) {
+            const double t = values[i] > 0.0 ? values[i] : 0.0;
+            const double position = t * MG_EASING_TABLE_SIZE;
+            const int truncated = (int) position;
+            const int index = truncated < MG_EASING_TABLE_SIZE ? truncated : MG_EASING_TABLE_SIZE - 1;
+            values[i] = table[index] + (table[index + 1] - table[index]) * (position - index);
+        }
+    }
+    else {
+        switch (curve->kind) {
+            case MGEasingKindLinear:
+                break;
+            case MGEasingKindInQuad:
+                for (size_t i = 0; i < count; ++i) {
+                    const double t = values[i];
+                    values[i] = t*t;
+                }
+                break;
+            case MGEasingKindOutQuad:
+                for (size_t i = 0; i < count; ++i) {
+                    const double t = values[i];
+                    values[i] = t*(2.0 - t);
+                }
+                break;
+            case MGEasingKindInOutQuad:
+                for (size_t i = 0; i < count; ++i) {
+                    const double t = values[i], u = 1.0 - t;
+                    const double in = 2.0*t*t, out = 1.0 - 2.0*u*u;
+                    values[i] = t < 0.5 ? in : out;
+                }
+                break;
+            case MGEasingKindInCubic:
+                for (size_t i = 0; i < count; ++i) {
+                    const double t = values[i];
+                    values[i] = t*t*t;
+                }
+                break;
+            case MGEasingKindOutCubic:
+                for (size_t i = 0; i < count; ++i) {
+                    const double u = values[i] - 1.0;
+                    values[i] = u*u*u + 1.0;
+                }
+                break;
+            case MGEasingKindInOutCubic:
+                for (size_t i = 0; i < count; ++i) {
+                    const double t = values[i], u = t - 1.0;
+                    const double in = 4.0*t*t*t, out = 4.0*u*u*u + 1.0;
+                    values[i] = t < 0.5 ? in : out;
+                }
+                break;
+            case MGEasingKindFunction: {
+                const MGEasingFunction function = curve->function;
+                for (size_t i = 0; i < count; ++i) {
+                    values[i] = function(values[i], 0.0, 1.0);
+                }
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        /* precise last value, like mgEasingCurveValue */
+        const double value = from[i] + (to[i] - from[i]) * values[i];
+        values[i] = elapsed[i] >= duration ? to[i] : value;
+    }
+}
+
+/* Buttons Layout */
+
+/** Same values as MGSwipeTransition */
+typedef enum MGSwipeLayoutTransition {
+    MGSwipeLayoutTransitionBorder = 0,
+    MGSwipeLayoutTransitionStatic,
+    MGSwipeLayoutTransitionDrag,
+    MGSwipeLayoutTransitionClipCenter,
+    MGSwipeLayoutTransitionRotate3D
+} MGSwipeLayoutTransition;
+
+/**
+ * Horizontal layout of the buttons of a MGSwipeButtonsView stored as flat arrays.
+ * Widths and resting offsets are cached when the buttons change, transitions only compute positions.
+ */
+typedef struct MGSwipeButtonsLayout {
+    size_t count;
+    double distance;    /* distance between buttons */
+    double * widths;
+    double * offsets;   /* resting x position of each button */
+    double * positions; /* x positions computed by the last transition */
+    double * clips;     /* horizontal clip inset of each side computed by the clip transition */
+    double * applied;   /* x positions last applied to the views, NAN if unknown */
+    bool uniformWidths; /* all the buttons have the same width, the transitions keep their edges sorted */
+} MGSwipeButtonsLayout;
+
+static inline void mgSwipeButtonsLayoutInit(MGSwipeButtonsLayout * layout, size_t count, double distance) {
+    layout->count = count;
+    layout->distance = distance;
+    layout->uniformWidths = true;
+    double * storage = (double *) calloc(count ? count * 5 : 1, sizeof(double));
+    layout->widths = storage;
+    layout->offsets = storage + count;
+    layout->positions = storage + count * 2;
+    layout->clips = storage + count * 3;
+    layout->applied = storage + count * 4;
+    for (size_t i = 0; i < count; ++i) {
+        layout->applied[i] = NAN;
+    }
+}
+
+static inline void mgSwipeButtonsLayoutFree(MGSwipeButtonsLayout * layout) {
+    free(layout->widths);
+    layout->widths = layout->offsets = layout->positions = layout->clips = layout->applied = NULL;
+    layout->count = 0;
+}
+
+/** Recomputes the resting offsets, must be called after the widths change */
+static inline void mgSwipeButtonsLayoutUpdateOffsets(MGSwipeButtonsLayout * layout) {
+    double offsetX = 0;
+    layout->uniformWidths = true;
+    for (size_t i = 0; i < layout->count; ++i) {
+        layout->uniformWidths = layout->uniformWidths && layout->widths[i] == layout->widths[0];
+        layout->offsets[i] = offsetX;
+        layout->positions[i] = offsetX;
+        layout->clips[i] = 0;
+        offsetX += layout->widths[i] + (i + 1 == layout->count ? 0 : layout->distance);
+    }
+}
+
+/** Forces the next apply pass to update every view, e.g. when the views were moved externally */
+static inline void mgSwipeButtonsLayoutInvalidate(MGSwipeButtonsLayout * layout) {
+    for (size_t i = 0; i < layout->count; ++i) {
+        layout->applied[i] = NAN;
+    }
+}
+
+/**
+ * Computes the positions of the buttons [first, end) for the transition t [0, 1] in a single pass.
+ * Returns false if the transition doesn't move the buttons individually (drag and 3D transitions).
+ */
+static inline bool mgSwipeButtonsLayoutTransitionRange(MGSwipeButtonsLayout * layout, MGSwipeLayoutTransition transition, double t, double width, bool fromLeft,
+                                                       size_t first, size_t end) {
+    const double * widths = layout->widths;
+    const double * offsets = layout->offsets;
+    double * positions = layout->positions;
+    switch (transition) {
+        case MGSwipeLayoutTransitionStatic: {
+            const double dx = fromLeft ? width * (1.0 - t) : -width * (1.0 - t);
+            for (size_t i = first; i < end; ++i) {
+                positions[i] = offsets[i] + dx;
+            }
+            return true;
+        }
+        case MGSwipeLayoutTransitionClipCenter: {
+            double * clips = layout->clips;
+            for (size_t i = first; i < end; ++i) {
+                const double dx = round(widths[i] * 0.5 * (1.0 - t));
+                clips[i] = dx;
+                positions[i] = fromLeft ? (width - widths[i] - offsets[i]) * (1.0 - t) + offsets[i] + dx : offsets[i] * t - dx;
+            }
+            return true;
+        }
+        case MGSwipeLayoutTransitionBorder: {
+            for (size_t i = first; i < end; ++i) {
+                positions[i] = fromLeft ? (width - widths[i] - offsets[i]) * (1.0 - t) + offsets[i] : offsets[i] * t;
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+static inline bool mgSwipeButtonsLayoutTransition(MGSwipeButtonsLayout * layout, MGSwipeLayoutTransition transition, double t, double width, bool fromLeft) {
+    return mgSwipeButtonsLayoutTransitionRange(layout, transition, t, width, fromLeft, 0, layout->count);
+}
+
+/** Left edge of button i at the transition t */
+static inline double mgSwipeButtonsLayoutPositionAt(MGSwipeButtonsLayout * layout, MGSwipeLayoutTransition transition, double t, double width, bool fromLeft, size_t i) {
+    return mgSwipeButtonsLayoutTransitionRange(layout, transition, t, width, fromLeft, i, i + 1) ? layout->positions[i] : layout->offsets[i];
+}
+
+/** True if button i intersects [visibleMin, visibleMax) at the transition t */
+static inline bool mgSwipeButtonsLayoutIsVisible(MGSwipeButtonsLayout * layout, MGSwipeLayoutTransition transition, double t, double width, bool fromLeft,
+                                                 double visibleMin, double visibleMax, size_t i) {
+    const double x = mgSwipeButtonsLayoutPositionAt(layout, transition, t, width, fromLeft, i);
+    return x < visibleMax && x + layout->widths[i] > visibleMin;
+}
+
+/**
+ * Range [first, end) containing all the buttons intersecting [visibleMin, visibleMax) at the transition t.
+ * Uses a binary search over the button edges, which are sorted for buttons with the same width.
+ * Buttons with different widths can overlap in the border and clip transitions, their edges aren't sorted and they are scanned
+ * linearly, the range then spans from the first to the last visible button.
+ * The 3D transition rotates the whole strip, all the buttons are returned.
+ */
+static inline void mgSwipeButtonsLayoutVisibleRange(MGSwipeButtonsLayout * layout, MGSwipeLayoutTransition transition, double t, double width, bool fromLeft,
+                                                    double visibleMin, double visibleMax, size_t * first, size_t * end) {
+    const size_t count = layout->count;
+    *first = 0;
+    *end = count;
+    if (transition == MGSwipeLayoutTransitionRotate3D || count == 0) {
+        return;
+    }
+    if (!layout->uniformWidths) {
+        *end = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (mgSwipeButtonsLayoutIsVisible(layout, transition, t, width, fromLeft, visibleMin, visibleMax, i)) {
+                *first = *end ? *first : i;
+                *end = i + 1;
+            }
+        }
+        *first = *end ? *first : 0;
+        return;
+    }
+    /* first button whose right edge is past visibleMin */
+    size_t low = 0, high = count;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (mgSwipeButtonsLayoutPositionAt(layout, transition, t, width, fromLeft, middle) + layout->widths[middle] <= visibleMin) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    *first = low;
+    /* first button whose left edge is past visibleMax */
+    high = count;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (mgSwipeButtonsLayoutPositionAt(layout, transition, t, width, fromLeft, middle) < visibleMax) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    *end = low;
+}
+
+/* Metrics Ring Buffer */
+
+typedef struct MGSwipeMetricSample {
+    int metric;
+    double value;
+} MGSwipeMetricSample;
+
+/**
+ * Lock free single producer / single consumer ring buffer of metric samples.
+ * Samples are recorded from the main thread and can be drained from any other thread.
+ */
+typedef struct MGSwipeMetricsRing {
+    MGSwipeMetricSample * samples;
+    size_t mask; /* capacity - 1, capacity is a power of two */
+    atomic_size_t head; /* next write position, only written by the producer */
+    atomic_size_t tail; /* next read position, only written by the consumer */
+    atomic_size_t dropped; /* samples discarded because the buffer was full */
+} MGSwipeMetricsRing;
+
+static inline void mgSwipeMetricsRingInit(MGSwipeMetricsRing * ring, size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    ring->samples = (MGSwipeMetricSample *) calloc(size, sizeof(MGSwipeMetricSample));
+    ring->mask = size - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->dropped, 0);
+}
+
+static inline void mgSwipeMetricsRingFree(MGSwipeMetricsRing * ring) {
+    free(ring->samples);
+    ring->samples = NULL;
+}
+
+static inline bool mgSwipeMetricsRingPush(MGSwipeMetricsRing * ring, int metric, double value) {
+    const size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    const size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail > ring->mask) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return false;
+    }
+    ring->samples[head & ring->mask].metric = metric;
+    ring->samples[head & ring->mask].value = value;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return true;
+}
+
+/** Pops up to max samples, returns the number of popped samples */
+static inline size_t mgSwipeMetricsRingPop(MGSwipeMetricsRing * ring, MGSwipeMetricSample * samples, size_t max) {
+    const size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    const size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t count = head - tail;
+    if (count > max) {
+        count = max;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] = ring->samples[(tail + i) & ring->mask];
+    }
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+    return count;
+}
+
+typedef struct MGSwipeMetricAggregate {
+    size_t count;
+    double total;
+    double maximum;
+} MGSwipeMetricAggregate;
+
+static inline void mgSwipeMetricAggregateAdd(MGSwipeMetricAggregate * aggregate, double value) {
+    aggregate->count++;
+    aggregate->total += value;
+    aggregate->maximum = aggregate->count == 1 ? value : fmax(aggregate->maximum, value);
+}
+
+/* Swipe State Machine */
+
+/** Same values as MGSwipeState */
+typedef enum MGSwipeCoreState {
+    MGSwipeCoreStateNone = 0,
+    MGSwipeCoreStateSwipingLeftToRight,
+    MGSwipeCoreStateSwipingRightToLeft,
+    MGSwipeCoreStateExpandingLeftToRight,
+    MGSwipeCoreStateExpandingRightToLeft
+} MGSwipeCoreState;
+
+/** Animation used to reach the target offset when the gesture ends */
+typedef enum MGSwipeReleaseAnimation {
+    MGSwipeReleaseAnimationHide = 0,
+    MGSwipeReleaseAnimationStretch,
+    MGSwipeReleaseAnimationShow
+} MGSwipeReleaseAnimation;
+
+/** Returns 0 if the offset is not allowed (no buttons, swipe disabled or opposite swipe) */
+static inline double mgSwipeFilterOffset(double offset, bool canSwipeLeftToRight, bool canSwipeRightToLeft, bool allowsOppositeSwipe, MGSwipeCoreState firstSwipeState) {
+    if (!(offset > 0 ? canSwipeLeftToRight : canSwipeRightToLeft)) {
+        return 0;
+    }
+    if (!allowsOppositeSwipe && firstSwipeState == MGSwipeCoreStateSwipingLeftToRight && offset < 0) {
+        return 0;
+    }
+    if (!allowsOppositeSwipe && firstSwipeState == MGSwipeCoreStateSwipingRightToLeft && offset > 0) {
+        return 0;
+    }
+    return offset;
+}
+
+/** Applies the bounce rate (or the clamp if bounces are disabled) beyond the buttons width */
+static inline double mgSwipeBounceOffset(double offset, double buttonsWidth, bool enableBounces, double bounceRate) {
+    const double sign = offset > 0 ? 1.0 : -1.0;
+    const double maxUnbouncedOffset = sign * buttonsWidth;
+    if (!enableBounces) {
+        return sign > 0 ? fmin(offset, maxUnbouncedOffset) : fmax(offset, maxUnbouncedOffset);
+    }
+    if ((sign > 0 && offset > maxUnbouncedOffset) || (sign < 0 && offset < maxUnbouncedOffset)) {
+        return maxUnbouncedOffset + (offset - maxUnbouncedOffset) * bounceRate;
+    }
+    return offset;
+}
+
+/** Offset where the swipe rests if the gesture ends at the given offset */
+static inline double mgSwipeRestingOffset(double offset, double buttonsWidth, bool keepButtonsSwiped, double threshold) {
+    const double sign = offset > 0 ? 1.0 : -1.0;
+    return keepButtonsSwiped && fabs(offset) > buttonsWidth * threshold ? buttonsWidth * sign : 0;
+}
+
+static inline bool mgSwipeShouldExpand(double offset, double buttonsWidth, long expansionIndex, double expansionThreshold) {
+    return expansionIndex >= 0 && fabs(offset) > buttonsWidth * expansionThreshold;
+}
+
+/**
+ * Applies the inertia rule when the gesture ends with a fast flick.
+ * leftWidth/rightWidth are the widths the buttons stay open at, or negative if they are not kept swiped.
+ */
+static inline double mgSwipeInertiaOffset(double offset, double targetOffset, double velocity, double inertiaThreshold, double leftWidth, double rightWidth) {
+    if (velocity > inertiaThreshold) {
+        return offset < 0 ? 0 : (leftWidth >= 0 ? leftWidth : targetOffset);
+    }
+    if (velocity < -inertiaThreshold) {
+        return offset > 0 ? 0 : (rightWidth >= 0 ? -rightWidth : targetOffset);
+    }
+    return targetOffset;
+}
+
+static inline MGSwipeReleaseAnimation mgSwipeReleaseAnimationFor(double offset, double targetOffset) {
+    if (targetOffset == 0) {
+        return MGSwipeReleaseAnimationHide;
+    }
+    return fabs(offset) > fabs(targetOffset) ? MGSwipeReleaseAnimationStretch : MGSwipeReleaseAnimationShow;
+}
+
+/** Settings of one swipe direction. Index 0 is left to right, 1 is right to left */
+typedef struct MGSwipeSideConfig {
+    double buttonsWidth; /* 0 if there are no buttons */
+    bool allowed;
+    bool enableBounces;
+    double bounceRate;
+    double threshold;
+    bool keepButtonsSwiped;
+    long expansionIndex; /* -1 if there is no expandable button */
+    double expansionThreshold;
+    bool fillOnTrigger;
+} MGSwipeSideConfig;
+
+typedef struct MGSwipeConfig {
+    MGSwipeSideConfig sides[2];
+    double cellWidth;
+    bool allowsOppositeSwipe;
+    double inertiaThreshold; /* points per second */
+} MGSwipeConfig;
+
+/** Swipe decision logic of a cell, without UIKit */
+typedef struct MGSwipeMachine {
+    MGSwipeConfig config;
+    double offset;
+    double targetOffset;
+    double panStartPoint;
+    double panStartOffset;
+    MGSwipeCoreState firstSwipeState;
+    MGSwipeCoreState state;
+} MGSwipeMachine;
+
+static inline void mgSwipeMachineInit(MGSwipeMachine * machine, const MGSwipeConfig * config) {
+    machine->config = *config;
+    machine->offset = machine->targetOffset = 0;
+    machine->panStartPoint = machine->panStartOffset = 0;
+    machine->firstSwipeState = MGSwipeCoreStateNone;
+    machine->state = MGSwipeCoreStateNone;
+}
+
+static inline bool mgSwipeMachineIsExpanding(const MGSwipeMachine * machine) {
+    return machine->state == MGSwipeCoreStateExpandingLeftToRight || machine->state == MGSwipeCoreStateExpandingRightToLeft;
+}
+
+static inline double mgSwipeMachineFilter(const MGSwipeMachine * machine, double offset) {
+    const MGSwipeConfig * c = &machine->config;
+    return mgSwipeFilterOffset(offset, c->sides[0].allowed && c->sides[0].buttonsWidth > 0, c->sides[1].allowed && c->sides[1].buttonsWidth > 0,
+                               c->allowsOppositeSwipe, machine->firstSwipeState);
+}
+
+/** Same rules as -[MGSwipeTableCell setSwipeOffset:] */
+static inline void mgSwipeMachineSetOffset(MGSwipeMachine * machine, double newOffset) {
+    const int side = newOffset > 0 ? 0 : 1;
+    const MGSwipeSideConfig * active = &machine->config.sides[side];
+    machine->offset = mgSwipeBounceOffset(newOffset, active->buttonsWidth, active->enableBounces, active->bounceRate);
+    if (active->buttonsWidth <= 0 || machine->offset == 0) {
+        machine->targetOffset = 0;
+        machine->state = MGSwipeCoreStateNone;
+        return;
+    }
+    machine->targetOffset = mgSwipeRestingOffset(machine->offset, active->buttonsWidth, active->keepButtonsSwiped, active->threshold);
+    if (mgSwipeShouldExpand(machine->offset, active->buttonsWidth, active->expansionIndex, active->expansionThreshold)) {
+        machine->targetOffset = active->fillOnTrigger ? machine->config.cellWidth * (side ? -1.0 : 1.0) : 0;
+        machine->state = side ? MGSwipeCoreStateExpandingRightToLeft : MGSwipeCoreStateExpandingLeftToRight;
+    }
+    else {
+        machine->state = side ? MGSwipeCoreStateSwipingRightToLeft : MGSwipeCoreStateSwipingLeftToRight;
+    }
+}
+
+static inline void mgSwipeMachinePanBegan(MGSwipeMachine * machine, double position) {
+    machine->panStartPoint = position;
+    machine->panStartOffset = machine->offset;
+    if (machine->offset != 0) {
+        machine->firstSwipeState = machine->offset > 0 ? MGSwipeCoreStateSwipingLeftToRight : MGSwipeCoreStateSwipingRightToLeft;
+    }
+}
+
+/** Returns the filtered offset for the pan position, without applying it */
+static inline double mgSwipeMachinePanOffset(MGSwipeMachine * machine, double position) {
+    const double offset = machine->panStartOffset + position - machine->panStartPoint;
+    if (machine->firstSwipeState == MGSwipeCoreStateNone) {
+        machine->firstSwipeState = offset > 0 ? MGSwipeCoreStateSwipingLeftToRight : MGSwipeCoreStateSwipingRightToLeft;
+    }
+    return mgSwipeMachineFilter(machine, offset);
+}
+
+static inline void mgSwipeMachinePanChanged(MGSwipeMachine * machine, double position) {
+    mgSwipeMachineSetOffset(machine, mgSwipeMachinePanOffset(machine, position));
+}
+
+/** Returns the animation used to reach machine->targetOffset. The offset is not changed until the animation ends */
+static inline MGSwipeReleaseAnimation mgSwipeMachinePanEnded(MGSwipeMachine * machine, double velocity) {
+    const MGSwipeConfig * c = &machine->config;
+    if (!mgSwipeMachineIsExpanding(machine)) {
+        const double leftWidth = c->sides[0].buttonsWidth > 0 && c->sides[0].keepButtonsSwiped ? c->sides[0].buttonsWidth : -1;
+        const double rightWidth = c->sides[1].buttonsWidth > 0 && c->sides[1].keepButtonsSwiped ? c->sides[1].buttonsWidth : -1;
+        machine->targetOffset = mgSwipeInertiaOffset(machine->offset, machine->targetOffset, velocity, c->inertiaThreshold, leftWidth, rightWidth);
+        machine->targetOffset = mgSwipeMachineFilter(machine, machine->targetOffset);
+    }
+    machine->firstSwipeState = MGSwipeCoreStateNone;
+    return mgSwipeReleaseAnimationFor(machine->offset, machine->targetOffset);
+}
+
+/* Gesture Trace Replay */
+
+typedef enum MGSwipeTouchPhase {
+    MGSwipeTouchPhaseBegan = 0,
+    MGSwipeTouchPhaseChanged,
+    MGSwipeTouchPhaseEnded
+} MGSwipeTouchPhase;
+
+/**
+ * Recorded or synthetic touch sample. position is the horizontal translation of the pan gesture.
+ * velocity (points per second) is only read at the end of the gesture, NAN estimates it from the timestamps (seconds)
+ */
+typedef struct MGSwipeTouchSample {
+    MGSwipeTouchPhase phase;
+    double position;
+    double velocity;
+    double timestamp;
+} MGSwipeTouchSample;
+
+/** Velocity at sample index, estimated from the previous sample if it wasn't recorded */
+static inline double mgSwipeTouchVelocity(const MGSwipeTouchSample * samples, size_t index) {
+    const MGSwipeTouchSample * sample = &samples[index];
+    if (!isnan(sample->velocity)) {
+        return sample->velocity;
+    }
+    if (index == 0 || sample->timestamp <= samples[index - 1].timestamp) {
+        return 0;
+    }
+    return (sample->position - samples[index - 1].position) / (sample->timestamp - samples[index - 1].timestamp);
+}
+
+/**
+ * Feeds a touch trace to the machine, ending animations are applied instantly.
+ * Writes the sequence of distinct states to states (up to maxStates) and returns the total number of state changes.
+ */
+static inline size_t mgSwipeMachineReplay(MGSwipeMachine * machine, const MGSwipeTouchSample * samples, size_t count,
+                                          MGSwipeCoreState * states, size_t maxStates) {
+    size_t changes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const MGSwipeCoreState previous = machine->state;
+        switch (samples[i].phase) {
+            case MGSwipeTouchPhaseBegan:
+                mgSwipeMachinePanBegan(machine, samples[i].position);
+                break;
+            case MGSwipeTouchPhaseChanged:
+                mgSwipeMachinePanChanged(machine, samples[i].position);
+                break;
+            case MGSwipeTouchPhaseEnded:
+                mgSwipeMachinePanEnded(machine, mgSwipeTouchVelocity(samples, i));
+                mgSwipeMachineSetOffset(machine, machine->targetOffset);
+                break;
+        }
+        if (machine->state != previous) {
+            if (states && changes < maxStates) {
+                states[changes] = machine->state;
+            }
+            changes++;
+        }
+    }
+    return changes;
+}
+
+/* Spring Physics */
+
+/** Distance (points) and speed (points per second) below which a spring is considered at rest */
+#define MG_SPRING_POSITION_TOLERANCE 0.25
+#define MG_SPRING_VELOCITY_TOLERANCE 2.0
+
+/**
+ * Critically damped spring: reaches the target as fast as possible without oscillating.
+ * It still overshoots once if it moves towards the target faster than omega times the distance,
+ * use mgSpringStepToTarget to stop at the target instead.
+ * The step is solved analytically, so it is stable for any frame interval.
+ */
+typedef struct MGSpring {
+    double position;
+    double velocity;
+    double target;
+    double omega; /* angular frequency, 2 * pi / response */
+} MGSpring;
+
+/** response is the period (seconds) of the equivalent undamped spring. Smaller values are stiffer */
+static inline void mgSpringInit(MGSpring * spring, double position, double velocity, double target, double response) {
+    spring->position = position;
+    spring->velocity = velocity;
+    spring->target = target;
+    spring->omega = 6.283185307179586 / fmax(response, 0.01);
+}
+
+/** Changes the target keeping the current position and velocity */
+static inline void mgSpringRetarget(MGSpring * spring, double target) {
+    spring->target = target;
+}
+
+static inline void mgSpringStep(MGSpring * spring, double dt) {
+    const double w = spring->omega;
+    const double x0 = spring->position - spring->target;
+    const double c = spring->velocity + w * x0;
+    const double decay = exp(-w * dt);
+    spring->position = spring->target + (x0 + c * dt) * decay;
+    spring->velocity = (spring->velocity - w * c * dt) * decay;
+}
+
+static inline bool mgSpringIsSettled(const MGSpring * spring) {
+    return fabs(spring->position - spring->target) < MG_SPRING_POSITION_TOLERANCE && fabs(spring->velocity) < MG_SPRING_VELOCITY_TOLERANCE;
+}
+
+/** Steps the spring, but rests at the target if the step crosses it, e.g. a fast close doesn't swipe past 0 */
+static inline void mgSpringStepToTarget(MGSpring * spring, double dt) {
+    const double before = spring->position - spring->target;
+    mgSpringStep(spring, dt);
+    const double after = spring->position - spring->target;
+    if ((before > 0 && after < 0) || (before < 0 && after > 0)) {
+        spring->position = spring->target;
+        spring->velocity = 0;
+    }
+}
+
+/**
+ * Offset where a flick would come to rest with scroll view like deceleration.
+ * decelerationRate is the velocity multiplier per millisecond (UIScrollViewDecelerationRateNormal is 0.998)
+ */
+static inline double mgSpringProjectedOffset(double offset, double velocity, double decelerationRate) {
+    return offset + velocity / 1000.0 * decelerationRate / (1.0 - decelerationRate);
+}
+
+/**
+ * Like mgSwipeMachinePanEnded, for the spring animation mode: the target is the resting offset
+ * closest to where the flick would come to rest, instead of the inertia rule
+ */
+static inline MGSwipeReleaseAnimation mgSwipeMachineSpringEnded(MGSwipeMachine * machine, double velocity, double decelerationRate) {
+    if (!mgSwipeMachineIsExpanding(machine)) {
+        const double projected = mgSpringProjectedOffset(machine->offset, velocity, decelerationRate);
+        const MGSwipeSideConfig * side = &machine->config.sides[projected > 0 ? 0 : 1];
+        const double resting = mgSwipeRestingOffset(projected, side->buttonsWidth, side->keepButtonsSwiped, side->threshold);
+        machine->targetOffset = mgSwipeMachineFilter(machine, resting);
+    }
+    machine->firstSwipeState = MGSwipeCoreStateNone;
+    return mgSwipeReleaseAnimationFor(machine->offset, machine->targetOffset);
+}
+
+/** Simulates the spring with a fixed frame interval and returns the time to settle, or maxTime if it doesn't */
+static inline double mgSpringSettleTime(MGSpring spring, double dt, double maxTime) {
+    double time = 0;
+    while (!mgSpringIsSettled(&spring) && time < maxTime) {
+        mgSpringStepToTarget(&spring, dt);
+        time += dt;
+    }
+    return time;
+}
+
+/* Event Ring */
+
+#define MG_EVENT_RING_CAPACITY 16
+
+/** Same values as MGSwipeEventType */
+typedef enum MGSwipeEventKind {
+    MGSwipeEventKindState = 0,
+    MGSwipeEventKindOffset
+} MGSwipeEventKind;
+
+typedef struct MGSwipeEventRecord {
+    MGSwipeEventKind kind;
+    int state;
+    double offset;
+    bool gestureIsActive;
+} MGSwipeEventRecord;
+
+/**
+ * Fixed size queue of the swipe events of a frame, used from a single thread.
+ * Consecutive offset events are merged and the oldest event is dropped when it's full.
+ */
+typedef struct MGSwipeEventRing {
+    MGSwipeEventRecord records[MG_EVENT_RING_CAPACITY];
+    size_t head;
+    size_t count;
+    size_t dropped;
+} MGSwipeEventRing;
+
+static inline void mgSwipeEventRingPush(MGSwipeEventRing * ring, MGSwipeEventRecord record) {
+    if (record.kind == MGSwipeEventKindOffset && ring->count > 0) {
+        MGSwipeEventRecord * last = &ring->records[(ring->head + ring->count - 1) % MG_EVENT_RING_CAPACITY];
+        if (last->kind == MGSwipeEventKindOffset) {
+            *last = record;
+            return;
+        }
+    }
+    if (ring->count == MG_EVENT_RING_CAPACITY) {
+        ring->head = (ring->head + 1) % MG_EVENT_RING_CAPACITY;
+        ring->count--;
+        ring->dropped++;
+    }
+    ring->records[(ring->head + ring->count) % MG_EVENT_RING_CAPACITY] = record;
+    ring->count++;
+}
+
+/** Copies the queued events in order to output (up to max) and empties the ring. Returns the number of copied events */
+static inline size_t mgSwipeEventRingDrain(MGSwipeEventRing * ring, MGSwipeEventRecord * output, size_t max) {
+    size_t count = ring->count < max ? ring->count : max;
+    for (size_t i = 0; i < count; ++i) {
+        output[i] = ring->records[(ring->head + i) % MG_EVENT_RING_CAPACITY];
+    }
+    ring->head = 0;
+    ring->count = 0;
+    return count;
+}
+
+/* Frame Pacing */
+
+/** Frame rate caps applied when the device is in Low Power Mode or under thermal pressure */
+#define MG_FRAME_RATE_POWER_SAVING 60.0
+#define MG_FRAME_RATE_CRITICAL 30.0
+
+/** Same values as NSProcessInfoThermalState */
+typedef enum MGThermalState {
+    MGThermalStateNominal = 0,
+    MGThermalStateFair,
+    MGThermalStateSerious,
+    MGThermalStateCritical
+} MGThermalState;
+
+/** Frame rates in frames per second. 0 maximum or preferred means no limit or no preference, like CAFrameRateRangeDefault */
+typedef struct MGFrameRateRange {
+    double minimum;
+    double maximum;
+    double preferred;
+} MGFrameRateRange;
+
+static inline bool mgFrameRateRangeIsDefault(MGFrameRateRange range) {
+    return range.minimum == 0 && range.maximum == 0 && range.preferred == 0;
+}
+
+/** Caps the range to 60 fps in Low Power Mode or serious thermal state and to 30 fps in critical thermal state */
+static inline MGFrameRateRange mgFrameRateRangeDownshift(MGFrameRateRange range, bool lowPowerMode, MGThermalState thermalState) {
+    double cap = 0;
+    if (thermalState >= MGThermalStateCritical) {
+        cap = MG_FRAME_RATE_CRITICAL;
+    }
+    else if (thermalState >= MGThermalStateSerious || lowPowerMode) {
+        cap = MG_FRAME_RATE_POWER_SAVING;
+    }
+    if (cap > 0) {
+        range.maximum = range.maximum > 0 ? fmin(range.maximum, cap) : cap;
+        range.preferred = range.preferred > 0 ? fmin(range.preferred, cap) : cap;
+        range.minimum = fmin(range.minimum, cap);
+    }
+    return range;
+}
+
+/** Smallest range that satisfies both clients of a shared display link */
+static inline MGFrameRateRange mgFrameRateRangeUnion(MGFrameRateRange a, MGFrameRateRange b) {
+    MGFrameRateRange range;
+    range.minimum = fmax(a.minimum, b.minimum);
+    range.maximum = a.maximum == 0 || b.maximum == 0 ? 0 : fmax(a.maximum, b.maximum);
+    range.preferred = a.preferred == 0 || b.preferred == 0 ? 0 : fmax(a.preferred, b.preferred);
+    return range;
+}
+
+/** Clamps the range to the display maximum and orders minimum <= preferred <= maximum */
+static inline MGFrameRateRange mgFrameRateRangeNormalize(MGFrameRateRange range, double displayMaximum) {
+    if (mgFrameRateRangeIsDefault(range)) {
+        return range;
+    }
+    if (displayMaximum > 0) {
+        range.maximum = range.maximum > 0 ? fmin(range.maximum, displayMaximum) : displayMaximum;
+    }
+    if (range.maximum > 0) {
+        range.minimum = fmin(range.minimum, range.maximum);
+        range.preferred = range.preferred > 0 ? fmin(range.preferred, range.maximum) : 0;
+    }
+    if (range.preferred > 0) {
+        range.preferred = fmax(range.preferred, range.minimum);
+    }
+    return range;
+}
+
+/** True if an animation tick moves the offset less than threshold points. The final tick is never skipped */
+static inline bool mgFramePacingShouldSkip(double previousOffset, double offset, double threshold, bool final) {
+    return !final && threshold > 0 && fabs(offset - previousOffset) < threshold;
+}
+
+/* Animation Ticker */
+
+/** Advances a client of the ticker to the timestamp */
+typedef void (*MGAnimationTickFunction)(void * client, double timestamp);
+/** Called when a client leaves the ticker. Deferred to the end of the tick when the client is removed while ticking */
+typedef void (*MGAnimationReleaseFunction)(void * client);
+
+typedef struct MGAnimationTickerEntry {
+    void * client;
+    MGFrameRateRange range;
+    bool constrains; /* false if the client has no frame rate preference */
+    bool adapts; /* the range is downshifted in power saving states */
+    bool removed;
+} MGAnimationTickerEntry;
+
+/**
+ * Active animation clients advanced together in a single tick, the core of MGSwipeAnimationScheduler.
+ * The clock is external: advance is called with the display link timestamps or with simulated ones.
+ * Clients removed during a tick are skipped and compacted at its end, clients added during a tick start on the next one
+ */
+typedef struct MGAnimationTicker {
+    MGAnimationTickerEntry * entries;
+    size_t count;
+    size_t capacity;
+    size_t active; /* entries not removed */
+    size_t current; /* entry being ticked */
+    bool ticking;
+    bool needsCompaction;
+    bool rangeChanged; /* a client constraining the frame rates was added, changed or removed */
+    MGAnimationTickFunction tick;
+    MGAnimationReleaseFunction release;
+} MGAnimationTicker;
+
+static inline void mgAnimationTickerInit(MGAnimationTicker * ticker, MGAnimationTickFunction tick, MGAnimationReleaseFunction release) {
+    ticker->entries = NULL;
+    ticker->count = ticker->capacity = ticker->active = ticker->current = 0;
+    ticker->ticking = ticker->needsCompaction = ticker->rangeChanged = false;
+    ticker->tick = tick;
+    ticker->release = release;
+}
+
+/** Releases the remaining clients and the storage */
+static inline void mgAnimationTickerFree(MGAnimationTicker * ticker) {
+    for (size_t i = 0; i < ticker->count; ++i) {
+        if (ticker->release) {
+            ticker->release(ticker->entries[i].client);
+        }
+    }
+    free(ticker->entries);
+    ticker->entries = NULL;
+    ticker->count = ticker->capacity = ticker->active = 0;
+}
+
+/** Returns false if the storage can't grow, the client isn't added then */
+static inline bool mgAnimationTickerAdd(MGAnimationTicker * ticker, void * client) {
+    if (ticker->count == ticker->capacity) {
+        const size_t capacity = ticker->capacity ? ticker->capacity * 2 : 16;
+        MGAnimationTickerEntry * entries = (MGAnimationTickerEntry *) realloc(ticker->entries, capacity * sizeof(MGAnimationTickerEntry));
+        if (!entries) {
+            return false;
+        }
+        ticker->entries = entries;
+        ticker->capacity = capacity;
+    }
+    MGAnimationTickerEntry * entry = &ticker->entries[ticker->count];
+    entry->client = client;
+    entry->constrains = entry->adapts = entry->removed = false;
+    ticker->count++;
+    ticker->active++;
+    return true;
+}
+
+/** Index of the first active entry of the client, or -1 */
+static inline long mgAnimationTickerIndexOf(const MGAnimationTicker * ticker, const void * client) {
+    /* clients usually remove themselves when they finish, from their own tick */
+    if (ticker->ticking && ticker->current < ticker->count && ticker->entries[ticker->current].client == client && !ticker->entries[ticker->current].removed) {
+        return (long) ticker->current;
+    }
+    for (size_t i = 0; i < ticker->count; ++i) {
+        if (ticker->entries[i].client == client && !ticker->entries[i].removed) {
+            return (long) i;
+        }
+    }
+    return -1;
+}
+
+static inline void mgAnimationTickerCompact(MGAnimationTicker * ticker) {
+    /* removals from the release callbacks are deferred too, entries stay in place until all of them are released */
+    const bool ticking = ticker->ticking;
+    ticker->ticking = true;
+    while (ticker->needsCompaction) {
+        ticker->needsCompaction = false;
+        for (size_t i = 0; i < ticker->count; ++i) {
+            if (ticker->entries[i].removed && ticker->entries[i].client) {
+                void * client = ticker->entries[i].client;
+                ticker->entries[i].client = NULL;
+                if (ticker->release) {
+                    ticker->release(client);
+                }
+            }
+        }
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < ticker->count; ++i) {
+        if (!ticker->entries[i].removed) {
+            ticker->entries[count++] = ticker->entries[i];
+        }
+    }
+    ticker->count = count;
+    ticker->ticking = ticking;
+}
+
+/** Returns false if the client isn't active */
+static inline bool mgAnimationTickerRemove(MGAnimationTicker * ticker, void * client) {
+    const long index = mgAnimationTickerIndexOf(ticker, client);
+    if (index < 0) {
+        return false;
+    }
+    ticker->entries[index].removed = true;
+    ticker->rangeChanged = ticker->rangeChanged || ticker->entries[index].constrains;
+    ticker->active--;
+    ticker->needsCompaction = true;
+    if (!ticker->ticking) {
+        mgAnimationTickerCompact(ticker);
+    }
+    return true;
+}
+
+/** Sets the frame rates requested by an active client. Returns false if the client isn't active */
+static inline bool mgAnimationTickerSetFrameRateRange(MGAnimationTicker * ticker, const void * client, MGFrameRateRange range, bool adapts) {
+    const long index = mgAnimationTickerIndexOf(ticker, client);
+    if (index < 0) {
+        return false;
+    }
+    MGAnimationTickerEntry * entry = &ticker->entries[index];
+    if (!entry->constrains || entry->adapts != adapts || entry->range.minimum != range.minimum ||
+        entry->range.maximum != range.maximum || entry->range.preferred != range.preferred) {
+        entry->range = range;
+        entry->constrains = true;
+        entry->adapts = adapts;
+        ticker->rangeChanged = true;
+    }
+    return true;
+}
+
+/**
+ * Union of the frame rates requested by the active clients, downshifted for the clients that adapt to the power state.
+ * Default range if no client constrains it. Clears rangeChanged
+ */
+static inline MGFrameRateRange mgAnimationTickerFrameRateRange(MGAnimationTicker * ticker, bool lowPowerMode, MGThermalState thermalState) {
+    MGFrameRateRange range = {0, 0, 0};
+    bool constrained = false;
+    for (size_t i = 0; i < ticker->count; ++i) {
+        const MGAnimationTickerEntry * entry = &ticker->entries[i];
+        if (entry->removed || !entry->constrains) {
+            continue;
+        }
+        const MGFrameRateRange clientRange = entry->adapts ? mgFrameRateRangeDownshift(entry->range, lowPowerMode, thermalState) : entry->range;
+        range = constrained ? mgFrameRateRangeUnion(range, clientRange) : clientRange;
+        constrained = true;
+    }
+    ticker->rangeChanged = false;
+    return range;
+}
+
+/** Returns true if clients were removed during the tick */
+static inline bool mgAnimationTickerAdvance(MGAnimationTicker * ticker, double timestamp) {
+    ticker->ticking = true;
+    /* clients added during the tick start on the next one. The storage may move when they are added */
+    const size_t count = ticker->count;
+    for (size_t i = 0; i < count; ++i) {
+        if (!ticker->entries[i].removed) {
+            ticker->current = i;
+            ticker->tick(ticker->entries[i].client, timestamp);
+        }
+    }
+    ticker->current = 0;
+    ticker->ticking = false;
+    if (!ticker->needsCompaction) {
+        return false;
+    }
+    mgAnimationTickerCompact(ticker);
+    return true;
+}
+
+#endif /* MGSwipeCore_h */
@@ -54,9 +54,97 @@ typedef NS_ENUM(NSInteger, MGSwipeEasingFunction) {
     MGSwipeEasingFunctionCubicInOut,
     MGSwipeEasingFunctionBounceIn,
     MGSwipeEasingFunctionBounceOut,
-    MGSwipeEasingFunctionBounceInOut
+    MGSwipeEasingFunctionBounceInOut,
+    MGSwipeEasingFunctionCubicBezier,
+    MGSwipeEasingFunctionSpring
 };
 
+/**
+ * Swipe animation mode
+ * Timed: show, hide and stretch animations run for a fixed duration with an easing function
+ * Spring: critically damped spring that starts from the gesture velocity and retargets without restarting
+ */
+typedef NS_ENUM(NSInteger, MGSwipeAnimationMode) {
+    MGSwipeAnimationModeTimed = 0,
+    MGSwipeAnimationModeSpring
+};
+
+/** Swipe event types delivered in batches when coalescesSwipeEvents is enabled */
+typedef NS_ENUM(NSInteger, MGSwipeEventType) {
+    MGSwipeEventTypeStateChange = 0,
+    MGSwipeEventTypeOffsetChange
+};
+
+/** Swipe event delivered in batches when coalescesSwipeEvents is enabled */
+typedef struct MGSwipeEvent {
+    MGSwipeEventType type;
+    MGSwipeState state;
+    CGFloat offset;
+    BOOL gestureIsActive;
+} MGSwipeEvent;
+
+/**
+ * Preferred frame rates of a swipe animation, in frames per second. Same meaning as CAFrameRateRange:
+ * 0 maximum or preferred means no limit or no preference. Zero values use the display default rate
+ */
+typedef struct MGSwipeFrameRateRange {
+    CGFloat minimum;
+    CGFloat maximum;
+    CGFloat preferred;
+} MGSwipeFrameRateRange;
+
+/** Swipe snapshot mode */
+typedef NS_ENUM(NSInteger, MGSwipeSnapshotMode) {
+    MGSwipeSnapshotModeBitmap = 0,
+    MGSwipeSnapshotModeView
+};
+
+/** Swipe performance metrics */
+typedef NS_ENUM(NSInteger, MGSwipeMetric) {
+    /** Seconds spent capturing the cell snapshot when the swipe starts */
+    MGSwipeMetricSnapshotDuration = 0,
+    /** Bytes of the snapshot bitmap (0 with MGSwipeSnapshotModeView) */
+    MGSwipeMetricSnapshotBytes,
+    /** Seconds spent fetching the buttons from the delegate */
+    MGSwipeMetricButtonsFetchDuration,
+    /** Seconds spent in each swipeOffset update */
+    MGSwipeMetricSetSwipeOffsetDuration,
+    /** Seconds spent setting up a button expansion */
+    MGSwipeMetricExpansionDuration,
+    /** Frames skipped between two swipe animation ticks */
+    MGSwipeMetricDroppedFrames,
+    /** Settings and animation objects allocated by a cell, sampled when it's initialized or reused and when it fetches the buttons
+     *  from the delegate. 0 while it shares the default settings */
+    MGSwipeMetricSettingsAllocations,
+    /** Instance bytes of the settings and animation objects counted by MGSwipeMetricSettingsAllocations */
+    MGSwipeMetricSettingsBytes,
+    MGSwipeMetricCount
+};
+
+/**
+ * Receives the swipe performance metrics. Samples are recorded on the main thread from the swipe hot paths,
+ * so implementations must be fast. See MGSwipeMetricsRecorder
+ */
+@protocol MGSwipeMetricsSink <NSObject>
+-(void) recordMetric:(MGSwipeMetric) metric value:(double) value;
+@end
+
+/**
+ * Metrics sink that records samples into a lock free ring buffer.
+ * Call drain to aggregate the recorded samples before reading them. drain, reset and the getters can be called from any thread
+ */
+@interface MGSwipeMetricsRecorder : NSObject <MGSwipeMetricsSink>
+/** Ring buffer capacity in samples (rounded up to a power of two). Default value 1024 */
+-(nonnull instancetype) initWithCapacity:(NSUInteger) capacity;
+-(void) drain;
+-(void) reset;
+-(NSUInteger) countForMetric:(MGSwipeMetric) metric;
+-(double) totalForMetric:(MGSwipeMetric) metric;
+-(double) maximumForMetric:(MGSwipeMetric) metric;
+/** Samples discarded because the ring buffer was full */
+@property (nonatomic, readonly) NSUInteger droppedSamples;
+@end
+
 /**
  * Swipe animation settings
  **/
@@ -65,8 +153,23 @@ typedef NS_ENUM(NSInteger, MGSwipeEasingFunction) {
 @property (nonatomic, assign) CGFloat duration;
 /** Animation easing function. Default value EaseOutBounce */
 @property (nonatomic, assign) MGSwipeEasingFunction easingFunction;
+/**
+ * Frame rates requested while the animation runs. Cells animating at the same time share one display link
+ * that runs at the highest requested rate. Default value {0, 0, 0}, the display default rate
+ */
+@property (nonatomic, assign) MGSwipeFrameRateRange frameRateRange;
 /** Override this method to implement custom easing functions */
 -(CGFloat) value:(CGFloat) elapsed duration:(CGFloat) duration from:(CGFloat) from to:(CGFloat) to;
+/** Evaluates count (elapsed, from, to) values in a single call. Uses value:duration:from:to: if it's overridden. values must not overlap the other arrays */
+-(void) values:(nonnull CGFloat *) values elapsed:(nonnull const CGFloat *) elapsed from:(nonnull const CGFloat *) from to:(nonnull const CGFloat *) to count:(NSUInteger) count duration:(CGFloat) duration;
+
+/** Sets a CSS like cubic bezier easing curve. Changes easingFunction to MGSwipeEasingFunctionCubicBezier */
+-(void) setCubicBezierControlPoint1:(CGPoint) point1 controlPoint2:(CGPoint) point2;
+/** Sets a spring easing curve that settles within the animation duration. Changes easingFunction to MGSwipeEasingFunctionSpring
+ * @param damping damping ratio between 0 and 1. 1 means critically damped (no oscillation)
+ * @param velocity initial velocity relative to the animated distance per animation duration
+ */
+-(void) setSpringDamping:(CGFloat) damping initialVelocity:(CGFloat) velocity;
 
 @end
 
@@ -98,6 +201,11 @@ typedef NS_ENUM(NSInteger, MGSwipeEasingFunction) {
 /** Animation settings when the cell is stretched from the swipe buttons */
 @property (nonatomic, strong, nonnull) MGSwipeAnimation * stretchAnimation;
 
+/** Animation mode used when the user ends swiping and by showSwipe/hideSwipe. Default value MGSwipeAnimationModeTimed */
+@property (nonatomic, assign) MGSwipeAnimationMode animationMode;
+/** Period in seconds of the spring used by MGSwipeAnimationModeSpring. Smaller values are stiffer. Default value 0.3 */
+@property (nonatomic, assign) CGFloat springResponse;
+
 /** Property to read or change swipe animation durations. Default value 0.3 */
 @property (nonatomic, assign) CGFloat animationDuration DEPRECATED_ATTRIBUTE;
 
@@ -119,6 +227,21 @@ typedef NS_ENUM(NSInteger, MGSwipeEasingFunction) {
 // default is NO. Controls whether buttons with different width are allowed. Buttons are resized to have the same size by default.
 @property (nonatomic) BOOL allowsButtonsWithDifferentWidth;
 
+/** If YES, buttons returned as MGSwipeButtonDescriptor are created as MGSwipeRenderedButton, drawn from the shared MGSwipeButtonImageCache. Default value NO */
+@property (nonatomic, assign) BOOL prerendersDescriptorButtons;
+
+/**
+ * If YES, only the buttons visible at the current swipe offset are attached to the buttons view, the rest are detached
+ * until the strip scrolls over them. Per frame layout cost doesn't grow with the number of buttons, useful for action strips
+ * with many buttons, wider than the cell. Default value NO
+ */
+@property (nonatomic, assign) BOOL virtualizesButtons;
+
+/** If YES, the animation frame rates are capped to 60 fps in Low Power Mode or serious thermal state and to 30 fps in critical thermal state. Default value YES */
+@property (nonatomic, assign) BOOL adaptsFrameRateToPowerState;
+/** Animation ticks that would move the swipe offset less than this distance in points are skipped, e.g. 1 / screen scale to skip sub pixel updates. Default value 0 */
+@property (nonatomic, assign) CGFloat minimumOffsetDelta;
+
 @end
 
 
@@ -171,6 +294,12 @@ typedef NS_ENUM(NSInteger, MGSwipeEasingFunction) {
  @param gestureIsActive YES if the user swipe gesture is active. No if the uses has already ended the gesture
  **/
 -(void) swipeTableCell:(nonnull MGSwipeTableCell*) cell didChangeSwipeState:(MGSwipeState) state gestureIsActive:(BOOL) gestureIsActive;
+/**
+ * Delegate method invoked once per frame with the swipe events of the frame when coalescesSwipeEvents is enabled.
+ * Consecutive offset changes are merged into the last one. If it's not implemented the state changes
+ * are delivered to swipeTableCell:didChangeSwipeState:gestureIsActive: instead.
+ */
+-(void) swipeTableCell:(nonnull MGSwipeTableCell*) cell didReceiveSwipeEvents:(nonnull const MGSwipeEvent *) events count:(NSUInteger) count;
 
 /**
  * Called when the user clicks a swipe button or when a expandable button is automatically triggered
@@ -190,6 +319,27 @@ typedef NS_ENUM(NSInteger, MGSwipeEasingFunction) {
 -(nullable NSArray<UIView*>*) swipeTableCell:(nonnull MGSwipeTableCell*) cell swipeButtonsForDirection:(MGSwipeDirection)direction
              swipeSettings:(nonnull MGSwipeSettings*) swipeSettings expansionSettings:(nonnull MGSwipeExpansionSettings*) expansionSettings;
 
+/**
+ * Alternative to swipeTableCell:swipeButtonsForDirection:swipeSettings:expansionSettings: returning lightweight button descriptors.
+ * Descriptors are cheap to create and are only turned into buttons when the swipe starts, keeping button creation out of the gesture recognition.
+ * Use +[MGSwipeButtonDescriptor prefetchDescriptors:] from the table prefetching to measure them in advance.
+ * If both methods are implemented the descriptors are used.
+ **/
+-(nullable NSArray<MGSwipeButtonDescriptor*>*) swipeTableCell:(nonnull MGSwipeTableCell*) cell swipeButtonDescriptorsForDirection:(MGSwipeDirection)direction
+             swipeSettings:(nonnull MGSwipeSettings*) swipeSettings expansionSettings:(nonnull MGSwipeExpansionSettings*) expansionSettings;
+
+/**
+ * Optional identifier of the buttons configuration returned for a direction.
+ * Cells of the same table returning the same identifier share prebuilt buttons through MGSwipeButtonsPool,
+ * so the buttons delegate method is only called when the pool has no matching buttons.
+ * Return a different identifier when the buttons or their settings change.
+ * Pooled buttons are shown by other rows: their callbacks must not capture row state, read it from the cell they receive
+ * (e.g. with indexPathForCell:) instead. Settings configured on the cell before the swipe are kept, the pooled
+ * buttons are laid out again with them and aren't pooled again. Cells with default settings adopt a copy of the
+ * settings configured with the buttons, changing it doesn't affect other rows.
+ **/
+-(nullable NSString *) swipeTableCell:(nonnull MGSwipeTableCell*) cell buttonsIdentifierForDirection:(MGSwipeDirection) direction;
+
 /**
  * Called when the user taps on a swiped cell
  * @return YES to autohide the current swipe buttons
@@ -210,6 +360,57 @@ typedef NS_ENUM(NSInteger, MGSwipeEasingFunction) {
 @end
 
 
+/**
+ * Table level pool of swipe buttons, keyed by the identifiers returned by swipeTableCell:buttonsIdentifierForDirection:
+ * Cells check out prebuilt buttons when they are swiped and return them when they are reused.
+ */
+@interface MGSwipeButtonsPool : NSObject
+/** Pool shared by all the cells of a table */
++(nonnull instancetype) poolForTableView:(nonnull UITableView *) tableView;
+/** Maximum number of button sets kept in the pool. Default value 16 */
+@property (nonatomic, assign) NSUInteger capacity;
+/** Number of button sets currently kept in the pool */
+@property (nonatomic, readonly) NSUInteger count;
+/** Number of swipes served with pooled buttons */
+@property (nonatomic, readonly) NSUInteger hits;
+/** Number of swipes that had to ask the delegate for new buttons */
+@property (nonatomic, readonly) NSUInteger misses;
+/** Releases all the pooled buttons */
+-(void) removeAllButtons;
+@end
+
+
+/**
+ * Per table coordinator tracking the cells that are swiped or being swiped.
+ * It shares a single input overlay among the cells of the table and allows bulk operations.
+ */
+@interface MGSwipeTableCoordinator : NSObject
+/** Coordinator shared by all the cells of a table */
++(nonnull instancetype) coordinatorForTableView:(nonnull UITableView *) tableView;
+/** Cells currently swiped or being swiped */
+@property (nonatomic, readonly, nonnull) NSArray<MGSwipeTableCell *> * activeCells;
+/** Hides all the swiped cells of the table. Animated cells advance together in the same animation frames */
+-(void) hideAllSwipedCellsAnimated:(BOOL) animated;
+-(void) hideAllSwipedCellsAnimated:(BOOL) animated completion:(nullable void(^)(BOOL finished)) completion;
+@end
+
+
+/**
+ * Drives the swipe animations from a single display link, so closing many cells at once
+ * advances them together in one tick instead of one CADisplayLink per cell.
+ */
+@interface MGSwipeAnimationScheduler : NSObject
+/** Scheduler used by the cells unless another one is assigned to MGSwipeTableCell.animationScheduler */
++(nonnull instancetype) sharedScheduler;
+/** Creates a scheduler without display link, advanceToTime: must be called to drive it (e.g. headless tests or benchmarks) */
+-(nonnull instancetype) initWithManualClock;
+/** Advances all the active animations to the timestamp, in seconds */
+-(void) advanceToTime:(CFTimeInterval) timestamp;
+/** Number of active animations and pending event deliveries */
+@property (nonatomic, readonly) NSUInteger activeCount;
+@end
+
+
 /**
  * Swipe Cell class
  * To implement swipe cells you have to override from this class
@@ -226,6 +427,7 @@ typedef NS_ENUM(NSInteger, MGSwipeEasingFunction) {
 /** 
  * Left and right swipe buttons and its settings.
  * Buttons can be any kind of UIView but it's recommended to use the convenience MGSwipeButton class
+ * Settings are shared with the other cells until they are first accessed, so cells that keep the defaults don't allocate them
  */
 @property (nonatomic, copy, nonnull) NSArray<UIView*> * leftButtons;
 @property (nonatomic, copy, nonnull) NSArray<UIView*> * rightButtons;
@@ -255,11 +457,35 @@ typedef NS_ENUM(NSInteger, MGSwipeEasingFunction) {
  Default behaviour is the same as the Mail app on iOS. Enable it if you want to allow to start a new swipe while a cell is already in swiped in a single step.  */
 @property (nonatomic) BOOL touchOnDismissSwipe;
 
+/* default is NO. If YES, state changes and offset updates are queued and delivered to the delegate once per frame
+ instead of synchronously from setSwipeOffset:. Use it when the delegate does heavy UI updates on state changes */
+@property (nonatomic) BOOL coalescesSwipeEvents;
+
+/** Controls how the cell contents are captured when the swipe starts. Default value MGSwipeSnapshotModeBitmap
+ ** MGSwipeSnapshotModeBitmap renders the cell into a bitmap on the CPU.
+ ** MGSwipeSnapshotModeView uses a GPU backed snapshot view instead. The cell must be on screen when the swipe starts.
+ ** The view snapshot reuses what is already on screen, so it doesn't render the cell synchronously, but changes made to the cell
+ ** in swipeTableCellWillBeginSwiping: aren't captured. Only a selection cleared by preservesSelectionStatus or a swipeContentView
+ ** removed from the cell update the screen first, which commits and renders the cell synchronously like the bitmap mode.
+ **/
+@property (nonatomic) MGSwipeSnapshotMode snapshotMode;
+/** Bytes allocated by the last bitmap snapshot, or the bytes it would have allocated when MGSwipeSnapshotModeView is used. Wide color bitmaps take 8 bytes per pixel */
+@property (nonatomic, readonly) NSUInteger snapshotBytes;
+
+/** Number of mask layers created by the clip transitions of the current swipe buttons, one per button. It doesn't grow while a swipe is dragged */
+@property (nonatomic, readonly) NSUInteger transitionMaskLayers;
+
 /** Optional background color for swipe overlay. If not set, its inferred automatically from the cell contentView */
 @property (nonatomic, strong, nullable) UIColor * swipeBackgroundColor;
 /** Property to read or change the current swipe offset programmatically */
 @property (nonatomic, assign) CGFloat swipeOffset;
 
+/** Scheduler that drives the animations of the cell. Default value: the shared scheduler */
+@property (nonatomic, strong, null_resettable) MGSwipeAnimationScheduler * animationScheduler;
+
+/** Optional sink for the swipe performance metrics of all the cells. Metrics are disabled when nil (default) */
+@property (class, nonatomic, strong, nullable) id<MGSwipeMetricsSink> metricsSink;
+
 /** Utility methods to show or hide swipe buttons programmatically */
 -(void) hideSwipeAnimated: (BOOL) animated;
 -(void) hideSwipeAnimated: (BOOL) animated completion:(nullable void(^)(BOOL finished)) completion;
@@ -271,6 +497,13 @@ typedef NS_ENUM(NSInteger, MGSwipeEasingFunction) {
 
 /** Refresh method to be used when you want to update the cell contents while the user is swiping */
 -(void) refreshContentView;
+/**
+ * Redraws only the rect (in the cell coordinate space) of the swiped cell snapshot. Unlike refreshContentView
+ * the swipe overlay, the gesture state and the delegate swiping events are kept, useful for live updating rows.
+ * Only the contentView subviews inside the rect are rendered, in both snapshot modes, and drawn over the snapshot.
+ * The accessory keeps the state captured when the swipe started. Does nothing if the cell isn't swiped
+ */
+-(void) refreshContentViewInRect:(CGRect) rect;
 /** Refresh method to be used when you want to dynamically change the left or right buttons (add or remove)
  * If you only want to change the title or the backgroundColor of a button you can change it's properties (get the button instance from leftButtons or rightButtons arrays)
  * @param usingDelegate if YES new buttons will be fetched using the MGSwipeTableCellDelegate. Otherwise new buttons will be fetched from leftButtons/rightButtons properties.
@@ -4,6 +4,61 @@
  */
 
 #import "MGSwipeTableCell.h"
+#import "MGSwipeCore.h"
+#import <objc/runtime.h>
+
+#pragma mark Delegate Capabilities
+
+/** Optional delegate methods implemented by the cell delegate, resolved once when the delegate is set */
+typedef NS_OPTIONS(NSUInteger, MGSwipeDelegateCapability) {
+    MGSwipeDelegateCapabilityCanSwipeFromPoint = 1 << 0,
+    MGSwipeDelegateCapabilityCanSwipe = 1 << 1,
+    MGSwipeDelegateCapabilityDidChangeSwipeState = 1 << 2,
+    MGSwipeDelegateCapabilityDidReceiveSwipeEvents = 1 << 3,
+    MGSwipeDelegateCapabilityTappedButton = 1 << 4,
+    MGSwipeDelegateCapabilitySwipeButtons = 1 << 5,
+    MGSwipeDelegateCapabilitySwipeButtonDescriptors = 1 << 6,
+    MGSwipeDelegateCapabilityButtonsIdentifier = 1 << 7,
+    MGSwipeDelegateCapabilityShouldHideSwipeOnTap = 1 << 8,
+    MGSwipeDelegateCapabilityWillBeginSwiping = 1 << 9,
+    MGSwipeDelegateCapabilityWillEndSwiping = 1 << 10
+};
+
+static MGSwipeDelegateCapability mgDelegateCapabilities(id delegate)
+{
+    if (!delegate) {
+        return 0;
+    }
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+    const struct { SEL selector; MGSwipeDelegateCapability capability; } selectors[] = {
+        {@selector(swipeTableCell:canSwipe:fromPoint:), MGSwipeDelegateCapabilityCanSwipeFromPoint},
+        {@selector(swipeTableCell:canSwipe:), MGSwipeDelegateCapabilityCanSwipe},
+        {@selector(swipeTableCell:didChangeSwipeState:gestureIsActive:), MGSwipeDelegateCapabilityDidChangeSwipeState},
+        {@selector(swipeTableCell:didReceiveSwipeEvents:count:), MGSwipeDelegateCapabilityDidReceiveSwipeEvents},
+        {@selector(swipeTableCell:tappedButtonAtIndex:direction:fromExpansion:), MGSwipeDelegateCapabilityTappedButton},
+        {@selector(swipeTableCell:swipeButtonsForDirection:swipeSettings:expansionSettings:), MGSwipeDelegateCapabilitySwipeButtons},
+        {@selector(swipeTableCell:swipeButtonDescriptorsForDirection:swipeSettings:expansionSettings:), MGSwipeDelegateCapabilitySwipeButtonDescriptors},
+        {@selector(swipeTableCell:buttonsIdentifierForDirection:), MGSwipeDelegateCapabilityButtonsIdentifier},
+        {@selector(swipeTableCell:shouldHideSwipeOnTap:), MGSwipeDelegateCapabilityShouldHideSwipeOnTap},
+        {@selector(swipeTableCellWillBeginSwiping:), MGSwipeDelegateCapabilityWillBeginSwiping},
+        {@selector(swipeTableCellWillEndSwiping:), MGSwipeDelegateCapabilityWillEndSwiping},
+    };
+#pragma clang diagnostic pop
+    MGSwipeDelegateCapability capabilities = 0;
+    for (size_t i = 0; i < sizeof(selectors) / sizeof(selectors[0]); ++i) {
+        if ([delegate respondsToSelector:selectors[i].selector]) {
+            capabilities |= selectors[i].capability;
+        }
+    }
+    return capabilities;
+}
+
+@interface MGSwipeTableCell ()
+/** YES if the current delegate implements the method. Capabilities are resolved once in setDelegate: */
+-(BOOL) delegateResponds:(MGSwipeDelegateCapability) capability;
+-(void) deliverSwipeEvents:(const MGSwipeEventRecord *) records count:(NSUInteger) count;
+@end
 
 #pragma mark Input Overlay Helper Class
 /** Used to capture table input while swipe buttons are visible*/
@@ -36,7 +91,7 @@
         return nil;
     }
     BOOL hide = YES;
-    if (_currentCell && _currentCell.delegate && [_currentCell.delegate respondsToSelector:@selector(swipeTableCell:shouldHideSwipeOnTap:)]) {
+    if (_currentCell && [_currentCell delegateResponds:MGSwipeDelegateCapabilityShouldHideSwipeOnTap]) {
         hide = [_currentCell.delegate swipeTableCell:_currentCell shouldHideSwipeOnTap:p];
     }
     if (hide) {
@@ -47,11 +102,181 @@
 
 @end
 
+#pragma mark Performance Metrics
+
+static id<MGSwipeMetricsSink> mgMetricsSink = nil;
+
+/** Returns 0 when no sink is installed, so disabled metrics only cost a pointer check */
+static inline CFTimeInterval mgMetricsStart(void)
+{
+    return mgMetricsSink ? CACurrentMediaTime() : 0;
+}
+
+static inline void mgMetricsRecord(MGSwipeMetric metric, double value)
+{
+    if (mgMetricsSink) {
+        [mgMetricsSink recordMetric:metric value:value];
+    }
+}
+
+static inline void mgMetricsRecordDuration(MGSwipeMetric metric, CFTimeInterval start)
+{
+    if (mgMetricsSink && start) {
+        [mgMetricsSink recordMetric:metric value:CACurrentMediaTime() - start];
+    }
+}
+
+/** Settings and animation objects allocated so far and their instance bytes, sampled around the cell init, reuse and buttons fetch */
+static atomic_size_t mgSettingsAllocations;
+static atomic_size_t mgSettingsBytes;
+
+typedef struct MGSettingsAllocationsSample {
+    size_t allocations;
+    size_t bytes;
+} MGSettingsAllocationsSample;
+
+static inline void mgMetricsCountSettingsAllocation(id object)
+{
+    atomic_fetch_add_explicit(&mgSettingsAllocations, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&mgSettingsBytes, class_getInstanceSize(object_getClass(object)), memory_order_relaxed);
+}
+
+static inline MGSettingsAllocationsSample mgMetricsSettingsAllocations(void)
+{
+    return (MGSettingsAllocationsSample) {
+        atomic_load_explicit(&mgSettingsAllocations, memory_order_relaxed),
+        atomic_load_explicit(&mgSettingsBytes, memory_order_relaxed)
+    };
+}
+
+/** Records the settings allocated since start, also when there are none */
+static inline void mgMetricsRecordSettingsAllocations(MGSettingsAllocationsSample start)
+{
+    if (mgMetricsSink) {
+        MGSettingsAllocationsSample now = mgMetricsSettingsAllocations();
+        [mgMetricsSink recordMetric:MGSwipeMetricSettingsAllocations value:now.allocations - start.allocations];
+        [mgMetricsSink recordMetric:MGSwipeMetricSettingsBytes value:now.bytes - start.bytes];
+    }
+}
+
+@implementation MGSwipeMetricsRecorder
+{
+    MGSwipeMetricsRing _ring;
+    MGSwipeMetricAggregate _aggregates[MGSwipeMetricCount];
+}
+
+-(instancetype) init
+{
+    return [self initWithCapacity:1024];
+}
+
+-(instancetype) initWithCapacity:(NSUInteger) capacity
+{
+    if (self = [super init]) {
+        mgSwipeMetricsRingInit(&_ring, capacity);
+    }
+    return self;
+}
+
+-(void) dealloc
+{
+    mgSwipeMetricsRingFree(&_ring);
+}
+
+-(void) recordMetric:(MGSwipeMetric) metric value:(double) value
+{
+    mgSwipeMetricsRingPush(&_ring, (int) metric, value);
+}
+
+static inline BOOL mgMetricIsValid(NSInteger metric)
+{
+    return metric >= 0 && metric < MGSwipeMetricCount;
+}
+
+//the consumer side (drain, reset and the aggregates) is serialized, so it can be used from several threads.
+//recordMetric: stays lock free
+-(void) drain
+{
+    @synchronized (self) {
+        MGSwipeMetricSample samples[64];
+        size_t count;
+        while ((count = mgSwipeMetricsRingPop(&_ring, samples, 64)) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                if (mgMetricIsValid(samples[i].metric)) {
+                    mgSwipeMetricAggregateAdd(&_aggregates[samples[i].metric], samples[i].value);
+                }
+            }
+        }
+    }
+}
+
+-(void) reset
+{
+    @synchronized (self) {
+        [self drain];
+        memset(_aggregates, 0, sizeof(_aggregates));
+    }
+}
+
+-(NSUInteger) countForMetric:(MGSwipeMetric) metric
+{
+    @synchronized (self) {
+        return mgMetricIsValid(metric) ? _aggregates[metric].count : 0;
+    }
+}
+
+-(double) totalForMetric:(MGSwipeMetric) metric
+{
+    @synchronized (self) {
+        return mgMetricIsValid(metric) ? _aggregates[metric].total : 0;
+    }
+}
+
+-(double) maximumForMetric:(MGSwipeMetric) metric
+{
+    @synchronized (self) {
+        return mgMetricIsValid(metric) ? _aggregates[metric].maximum : 0;
+    }
+}
+
+-(NSUInteger) droppedSamples
+{
+    return atomic_load(&_ring.dropped);
+}
+
+@end
+
+#pragma mark Shared Animation Scheduler
+
+/** Objects animated by a MGSwipeAnimationScheduler */
+@protocol MGSwipeAnimationClient <NSObject>
+-(void) advanceAnimation:(CFTimeInterval) timestamp;
+@end
+
+/** Used by the cells, their buttons views and event queues. Clients are retained while they are active, like a CADisplayLink retains its target */
+@interface MGSwipeAnimationScheduler ()
+/** Adds a client without frame rate preference, it doesn't constrain the display link */
+-(void) addClient:(id<MGSwipeAnimationClient>) client;
+-(void) addClient:(id<MGSwipeAnimationClient>) client frameRateRange:(MGSwipeFrameRateRange) range adaptsToPowerState:(BOOL) adapts;
+-(void) removeClient:(id<MGSwipeAnimationClient>) client;
+/** Changes the frame rates requested by an active client, e.g. when a spring is retargeted */
+-(void) setFrameRateRange:(MGSwipeFrameRateRange) range adaptsToPowerState:(BOOL) adapts forClient:(id<MGSwipeAnimationClient>) client;
+/** Union of the frame rates requested by the active clients, applied to the display link. Computed when the clients change */
+@property (nonatomic, readonly) MGFrameRateRange frameRateRange;
+/** Power signals, tracked from NSProcessInfo unless the scheduler uses a manual clock */
+@property (nonatomic, assign) BOOL lowPowerMode;
+@property (nonatomic, assign) MGThermalState thermalState;
+/** Maximum display frame rate, 0 if unknown. Tracked from UIScreen unless the scheduler uses a manual clock */
+@property (nonatomic, assign) double displayMaximumFrameRate;
+@end
+
 #pragma mark Button Container View and transitions
 
-@interface MGSwipeButtonsView : UIView
+@interface MGSwipeButtonsView : UIView <MGSwipeAnimationClient>
 @property (nonatomic, weak) MGSwipeTableCell * cell;
 @property (nonatomic, strong) UIColor * backgroundColorCopy;
+/** Number of mask layers created by the clip transition. Constant once every button has its mask */
+@property (nonatomic, readonly) NSUInteger transitionMaskLayers;
 @end
 
 @implementation MGSwipeButtonsView
@@ -60,16 +285,33 @@
     UIView * _container;
     BOOL _fromLeft;
     UIView * _expandedButton;
-    UIView * _expandedButtonAnimated;
-    UIView * _expansionBackground;
-    UIView * _expansionBackgroundAnimated;
-    CGRect _expandedButtonBoundsCopy;
     MGSwipeDirection _direction;
+    //expansion state, interpolated from the animation scheduler of the cell
+    MGSwipeAnimationScheduler * _expansionScheduler; //scheduler driving the expansion animation, nil if not animating
+    UIView * _expansionButton; //expanded or collapsing button
+    UIView * _expansionBackground; //persistent, hidden while there is no expansion
     MGSwipeExpansionLayout _expansionLayout;
     CGFloat _expansionOffset;
+    CGFloat _expansionProgress;
+    CGFloat _expansionTarget;
+    CGFloat _expansionDuration;
+    CGFloat _expansionAnchor;
+    CGFloat _expansionButtonWidth;
+    CFTimeInterval _expansionTimestamp;
+    BOOL _expansionAnimating;
+    MGSwipeFrameRateRange _expansionFrameRateRange;
+    BOOL _adaptsFrameRate;
+    MGSwipeTransition _lastTransition;
+    CGFloat _lastTransitionPercent;
+    BOOL _hasLastTransition;
     CGFloat _buttonsDistance;
     CGFloat _safeInset;
     BOOL _autoHideExpansion;
+    MGSwipeButtonsLayout _layout;
+    NSMutableArray<CALayer *> * _clipMasks;
+    BOOL _virtualizesButtons;
+    NSUInteger _attachedFirst; //buttons [_attachedFirst, _attachedEnd) are subviews of the container
+    NSUInteger _attachedEnd;
 }
 
 #pragma mark Layout
@@ -96,11 +338,14 @@
         _container.backgroundColor = [UIColor clearColor];
         _direction = direction;
         _safeInset = safeInset;
+        _virtualizesButtons = settings.virtualizesButtons;
+        _adaptsFrameRate = settings.adaptsFrameRateToPowerState;
         [self addSubview:_container];
         _buttons = _fromLeft ? buttonsArray: [[buttonsArray reverseObjectEnumerator] allObjects];
+        mgSwipeButtonsLayoutInit(&_layout, _buttons.count, _buttonsDistance);
         for (UIView * button in _buttons) {
-            if ([button isKindOfClass:[UIButton class]]) {
-                UIButton * btn = (UIButton*)button;
+            if ([button isKindOfClass:[UIControl class]]) {
+                UIControl * btn = (UIControl*)button;
                 [btn removeTarget:nil action:@selector(mgButtonClicked:) forControlEvents:UIControlEventTouchUpInside]; //Remove all targets to avoid problems with reused buttons among many cells
                 [btn addTarget:self action:@selector(mgButtonClicked:) forControlEvents:UIControlEventTouchUpInside];
             }
@@ -108,8 +353,11 @@
                 button.frame = CGRectMake(0, 0, maxSize.width, maxSize.height);
             }
             button.autoresizingMask = UIViewAutoresizingFlexibleHeight;
-            [_container insertSubview:button atIndex: _fromLeft ? 0: _container.subviews.count];
+            if (!_virtualizesButtons) { //virtualized buttons are attached by the transitions when they become visible
+                [_container insertSubview:button atIndex: _fromLeft ? 0: _container.subviews.count];
+            }
         }
+        _attachedEnd = _virtualizesButtons ? 0 : _buttons.count;
         // Expand last button to make it look good with a notch.
         if (safeInset > 0 && settings.expandLastButtonBySafeAreaInsets && _buttons.count > 0) {
             UIView * notchButton = _direction == MGSwipeDirectionRightToLeft ? [_buttons lastObject] : [_buttons firstObject];
@@ -124,20 +372,42 @@
 -(void) dealloc
 {
     for (UIView * button in _buttons) {
-        if ([button isKindOfClass:[UIButton class]]) {
-            [(UIButton *)button removeTarget:self action:@selector(mgButtonClicked:) forControlEvents:UIControlEventTouchUpInside];
+        if ([button isKindOfClass:[UIControl class]]) {
+            [(UIControl *)button removeTarget:self action:@selector(mgButtonClicked:) forControlEvents:UIControlEventTouchUpInside];
         }
     }
+    mgSwipeButtonsLayoutFree(&_layout);
 }
 
 -(void) resetButtons
 {
-    CGFloat offsetX = 0;
-    UIView* lastButton = [_buttons lastObject];
+    //refresh the cached widths, transitions only read the layout arrays
+    NSUInteger index = 0;
+    for (UIView * button in _buttons) {
+        _layout.widths[index++] = button.bounds.size.width;
+    }
+    mgSwipeButtonsLayoutUpdateOffsets(&_layout);
+    index = 0;
     for (UIView * button in _buttons) {
-        button.frame = CGRectMake(offsetX, 0, button.bounds.size.width, self.bounds.size.height);
+        const CGFloat offsetX = _layout.offsets[index];
+        button.frame = CGRectMake(offsetX, 0, _layout.widths[index], self.bounds.size.height);
         button.autoresizingMask = UIViewAutoresizingFlexibleHeight;
-        offsetX += button.bounds.size.width + (lastButton == button ? 0 : _buttonsDistance);
+        _layout.applied[index++] = offsetX;
+    }
+}
+
+-(void) applyLayoutPositions
+{
+    for (NSUInteger i = _attachedFirst; i < _attachedEnd; ++i) {
+        const CGFloat x = _layout.positions[i];
+        if (x == _layout.applied[i]) {
+            continue; //only touch the views whose frame changes
+        }
+        _layout.applied[i] = x;
+        UIView * button = [_buttons objectAtIndex:i];
+        CGRect frame = button.frame;
+        frame.origin.x = x;
+        button.frame = frame;
     }
 }
 
@@ -184,138 +454,239 @@
         }
         btn.contentEdgeInsets = contentInsets;
     }
+    else if ([view isKindOfClass:[MGSwipeRenderedButton class]]) {
+        MGSwipeRenderedButton * btn = (MGSwipeRenderedButton *) view;
+        UIEdgeInsets contentInsets = btn.edgeInsets;
+        if (_direction == MGSwipeDirectionRightToLeft) {
+            contentInsets.right += delta;
+        }
+        else {
+            contentInsets.left += delta;
+        }
+        btn.edgeInsets = contentInsets;
+    }
 }
 
 -(void) layoutExpansion: (CGFloat) offset
 {
     _expansionOffset = offset;
-    _container.frame = CGRectMake(_fromLeft ? 0: self.bounds.size.width - offset, 0, offset, self.bounds.size.height);
-    if (_expansionBackgroundAnimated && _expandedButtonAnimated) {
-        _expansionBackgroundAnimated.frame = [self expansionBackgroundRect:_expandedButtonAnimated];
-    }
+    [self applyExpansionState];
 }
 
 -(void) layoutSubviews
 {
     [super layoutSubviews];
-    if (_expandedButton) {
-        [self layoutExpansion:_expansionOffset];
+    if (_expansionButton) {
+        [self applyExpansionState];
     }
     else {
         _container.frame = self.bounds;
     }
 }
 
--(CGRect) expansionBackgroundRect: (UIView *) button
+-(CGRect) expansionBackgroundRect: (CGRect) buttonFrame
 {
     CGFloat extra = 100.0f; //extra size to avoid expansion background size issue on iOS 7.0
     if (_fromLeft) {
-        return CGRectMake(-extra, 0, button.frame.origin.x + extra, _container.bounds.size.height);
+        return CGRectMake(-extra, 0, buttonFrame.origin.x + extra, _container.bounds.size.height);
     }
     else {
-        return CGRectMake(button.frame.origin.x +  button.bounds.size.width, 0,
-                   _container.bounds.size.width - (button.frame.origin.x + button.bounds.size.width ) + extra
+        return CGRectMake(buttonFrame.origin.x +  buttonFrame.size.width, 0,
+                   _container.bounds.size.width - (buttonFrame.origin.x + buttonFrame.size.width ) + extra
                           ,_container.bounds.size.height);
     }
     
 }
 
+static inline CGRect mgInterpolateRect(CGRect from, CGRect to, CGFloat t)
+{
+    return CGRectMake(from.origin.x + (to.origin.x - from.origin.x) * t,
+                      from.origin.y + (to.origin.y - from.origin.y) * t,
+                      from.size.width + (to.size.width - from.size.width) * t,
+                      from.size.height + (to.size.height - from.size.height) * t);
+}
+
+/** Lays out the container, the expanded button and the expansion background from the current interpolated progress */
+-(void) applyExpansionState
+{
+    if (!_expansionButton) {
+        return;
+    }
+    const CGFloat t = mgEaseInOutQuad(_expansionProgress, 0, 1);
+    CGRect expandedContainer = CGRectMake(_fromLeft ? 0: self.bounds.size.width - _expansionOffset, 0, _expansionOffset, self.bounds.size.height);
+    //the container follows the offset while expanded and returns to the bounds when the expansion ends
+    _container.frame = _expandedButton ? expandedContainer : mgInterpolateRect(self.bounds, expandedContainer, t);
+
+    const CGSize size = _container.bounds.size;
+    //the button keeps its distance to the edge the buttons grow from
+    CGRect collapsed = CGRectMake(_fromLeft ? _expansionAnchor : size.width - _expansionAnchor, 0, _expansionButtonWidth, size.height);
+    CGRect expanded = collapsed;
+    if (_expansionLayout == MGSwipeExpansionLayoutCenter) {
+        expanded = CGRectMake(0, 0, size.width, size.height);
+    }
+    else if (_expansionLayout == MGSwipeExpansionLayoutBorder) {
+        expanded.origin.x = _fromLeft ? size.width - _expansionButtonWidth : 0;
+    }
+    CGRect buttonFrame = mgInterpolateRect(collapsed, expanded, t);
+    if (!CGRectEqualToRect(_expansionButton.frame, buttonFrame)) {
+        _expansionButton.frame = buttonFrame;
+    }
+    CGRect backgroundFrame = [self expansionBackgroundRect:buttonFrame];
+    if (_expansionLayout == MGSwipeExpansionLayoutNone) {
+        backgroundFrame = mgInterpolateRect(backgroundFrame, _container.bounds, t);
+    }
+    if (!CGRectEqualToRect(_expansionBackground.frame, backgroundFrame)) {
+        _expansionBackground.frame = backgroundFrame;
+    }
+}
+
+/** Animates the expansion progress towards target from the scheduler tick that also drives swipeOffset */
+-(void) animateExpansionTo:(CGFloat) target animated:(BOOL) animated
+{
+    _expansionTarget = target;
+    if (!animated || _expansionDuration <= 0 || _expansionProgress == target) {
+        _expansionProgress = target;
+        [self stopExpansionAnimation];
+        [self applyExpansionState];
+        [self expansionAnimationDidReachTarget];
+        return;
+    }
+    if (!_expansionAnimating) {
+        _expansionAnimating = YES;
+        _expansionTimestamp = 0;
+        _expansionScheduler = _cell.animationScheduler ?: [MGSwipeAnimationScheduler sharedScheduler];
+        [_expansionScheduler addClient:self frameRateRange:_expansionFrameRateRange adaptsToPowerState:_adaptsFrameRate];
+    }
+}
+
+-(void) stopExpansionAnimation
+{
+    if (_expansionAnimating) {
+        _expansionAnimating = NO;
+        [_expansionScheduler removeClient:self];
+        _expansionScheduler = nil;
+    }
+}
+
+-(void) advanceAnimation:(CFTimeInterval) timestamp
+{
+    CFTimeInterval dt = _expansionTimestamp ? timestamp - _expansionTimestamp : 0;
+    _expansionTimestamp = timestamp;
+    //progress moves at constant speed so reversing mid animation continues from the current state
+    CGFloat step = dt / _expansionDuration;
+    _expansionProgress = _expansionTarget > _expansionProgress ? MIN(_expansionTarget, _expansionProgress + step) : MAX(_expansionTarget, _expansionProgress - step);
+    [self applyExpansionState];
+    if (_expansionProgress == _expansionTarget) {
+        [self stopExpansionAnimation];
+        [self expansionAnimationDidReachTarget];
+    }
+}
+
+-(void) expansionAnimationDidReachTarget
+{
+    if (_expansionTarget > 0 || _expandedButton) {
+        return;
+    }
+    //collapsed: hide the background and give the buttons back to the transitions
+    _expansionBackground.hidden = YES;
+    _expansionButton = nil;
+    _container.frame = self.bounds;
+    mgSwipeButtonsLayoutInvalidate(&_layout);
+    [self resetButtons];
+    if (_hasLastTransition) {
+        [self transition:_lastTransition percent:_lastTransitionPercent];
+    }
+}
+
 -(void) expandToOffset:(CGFloat) offset settings:(MGSwipeExpansionSettings*) settings
 {
     if (settings.buttonIndex < 0 || settings.buttonIndex >= _buttons.count) {
         return;
     }
-    if (!_expandedButton) {
-        _expandedButton = [_buttons objectAtIndex: _fromLeft ? settings.buttonIndex : _buttons.count - settings.buttonIndex - 1];
-        CGRect previusRect = _container.frame;
-        [self layoutExpansion:offset];
-        [self resetButtons];
-        if (!_fromLeft) { //Fix expansion animation for right buttons
-            for (UIView * button in _buttons) {
-                CGRect frame = button.frame;
-                frame.origin.x += _container.bounds.size.width - previusRect.size.width;
-                button.frame = frame;
-            }
+    UIView * button = [_buttons objectAtIndex: _fromLeft ? settings.buttonIndex : _buttons.count - settings.buttonIndex - 1];
+    if (_expandedButton || (_expansionButton == button && _expansionTarget == 0)) {
+        //already expanded or crossing back the threshold while collapsing: only retarget, no new views or transactions
+        if (!_expandedButton && settings.expansionColor) {
+            _backgroundColorCopy = button.backgroundColor;
+            button.backgroundColor = settings.expansionColor;
+            _expansionBackground.backgroundColor = settings.expansionColor;
         }
-        _expansionBackground = [[UIView alloc] initWithFrame:[self expansionBackgroundRect:_expandedButton]];
-        _expansionBackground.autoresizingMask = UIViewAutoresizingFlexibleWidth | UIViewAutoresizingFlexibleHeight;
-        if (settings.expansionColor) {
-            _backgroundColorCopy = _expandedButton.backgroundColor;
-            _expandedButton.backgroundColor = settings.expansionColor;
-        }
-        _expansionBackground.backgroundColor = _expandedButton.backgroundColor;
-        if (UIColor.clearColor == _expandedButton.backgroundColor) {
-          // Provides access to more complex content for display on the background
-          _expansionBackground.layer.contents = _expandedButton.layer.contents;
+        _expandedButton = button;
+        _expansionOffset = offset;
+        [self animateExpansionTo:1 animated:YES];
+        return;
+    }
+    CFTimeInterval metricsStart = mgMetricsStart();
+    if (_expansionButton) { //collapsing a different button, finish it
+        [self animateExpansionTo:0 animated:NO];
+    }
+    _expandedButton = button;
+    _expansionButton = button;
+    _expansionOffset = offset;
+    [self attachButtonsFrom:0 to:_buttons.count]; //the expansion moves the whole strip, virtualization resumes after the collapse
+    _expansionLayout = settings.expansionLayout;
+    _expansionDuration = settings.animationDuration;
+    _expansionFrameRateRange = settings.triggerAnimation.frameRateRange;
+    CGRect previusRect = _container.frame;
+    _container.frame = CGRectMake(_fromLeft ? 0: self.bounds.size.width - offset, 0, offset, self.bounds.size.height);
+    [self resetButtons];
+    if (!_fromLeft) { //Fix expansion animation for right buttons
+        for (UIView * button in _buttons) {
+            CGRect frame = button.frame;
+            frame.origin.x += _container.bounds.size.width - previusRect.size.width;
+            button.frame = frame;
         }
-        [_container addSubview:_expansionBackground];
-        _expansionLayout = settings.expansionLayout;
-        
-        CGFloat duration = _fromLeft ? _cell.leftExpansion.animationDuration : _cell.rightExpansion.animationDuration;
-        [UIView animateWithDuration: duration delay:0 options:UIViewAnimationOptionBeginFromCurrentState animations:^{
-            self->_expandedButton.hidden = NO;
-
-            if (self->_expansionLayout == MGSwipeExpansionLayoutCenter) {
-                self->_expandedButtonBoundsCopy = self->_expandedButton.bounds;
-                self->_expandedButton.layer.mask = nil;
-                self->_expandedButton.layer.transform = CATransform3DIdentity;
-                self->_expandedButton.autoresizingMask = UIViewAutoresizingFlexibleHeight | UIViewAutoresizingFlexibleWidth;
-                [self->_expandedButton.superview bringSubviewToFront:self->_expandedButton];
-                self->_expandedButton.frame = self->_container.bounds;
-                self->_expansionBackground.frame = [self expansionBackgroundRect:self->_expandedButton];
-            }
-            else if (self->_expansionLayout == MGSwipeExpansionLayoutNone) {
-                [self->_expandedButton.superview bringSubviewToFront:self->_expandedButton];
-                self->_expansionBackground.frame = self->_container.bounds;
-            }
-            else if (self->_fromLeft) {
-                self->_expandedButton.frame = CGRectMake(self->_container.bounds.size.width - self->_expandedButton.bounds.size.width, 0, self->_expandedButton.bounds.size.width, self->_expandedButton.bounds.size.height);
-                self->_expandedButton.autoresizingMask|= UIViewAutoresizingFlexibleLeftMargin;
-                self->_expansionBackground.frame = [self expansionBackgroundRect:self->_expandedButton];
-            }
-            else {
-                self->_expandedButton.frame = CGRectMake(0, 0, self->_expandedButton.bounds.size.width, self->_expandedButton.bounds.size.height);
-                self->_expandedButton.autoresizingMask|= UIViewAutoresizingFlexibleRightMargin;
-                self->_expansionBackground.frame = [self expansionBackgroundRect:self->_expandedButton];
-            }
+    }
+    mgSwipeButtonsLayoutInvalidate(&_layout); //the expansion moves the buttons outside of the layout
+    _expansionButtonWidth = _expandedButton.bounds.size.width;
+    _expansionAnchor = _fromLeft ? _expandedButton.frame.origin.x : _container.bounds.size.width - _expandedButton.frame.origin.x;
 
-        } completion:^(BOOL finished) {
-        }];
-        return;
+    if (!_expansionBackground) {
+        //one background for the life of the view, hidden while there is no expansion
+        _expansionBackground = [[UIView alloc] initWithFrame:CGRectZero];
+        _expansionBackground.autoresizingMask = UIViewAutoresizingFlexibleHeight;
+    }
+    if (settings.expansionColor) {
+        _backgroundColorCopy = _expandedButton.backgroundColor;
+        _expandedButton.backgroundColor = settings.expansionColor;
+    }
+    _expansionBackground.backgroundColor = _expandedButton.backgroundColor;
+    // Provides access to more complex content for display on the background
+    _expansionBackground.layer.contents = UIColor.clearColor == _expandedButton.backgroundColor ? _expandedButton.layer.contents : nil;
+    _expansionBackground.hidden = NO;
+    if (_expansionBackground.superview != _container) {
+        [_container addSubview:_expansionBackground];
+    }
+    else {
+        [_container bringSubviewToFront:_expansionBackground];
+    }
+    _expandedButton.hidden = NO;
+    if (_expansionLayout == MGSwipeExpansionLayoutCenter) {
+        _expandedButton.layer.mask = nil;
+        _expandedButton.layer.transform = CATransform3DIdentity;
     }
-    [self layoutExpansion:offset];
+    if (_expansionLayout != MGSwipeExpansionLayoutBorder) {
+        [_container bringSubviewToFront:_expandedButton];
+    }
+    _expansionProgress = 0;
+    [self applyExpansionState];
+    [self animateExpansionTo:1 animated:YES];
+    mgMetricsRecordDuration(MGSwipeMetricExpansionDuration, metricsStart);
 }
 
 -(void) endExpansionAnimated:(BOOL) animated
 {
     if (_expandedButton) {
-        _expandedButtonAnimated = _expandedButton;
-        if (_expansionBackgroundAnimated && _expansionBackgroundAnimated != _expansionBackground) {
-            [_expansionBackgroundAnimated removeFromSuperview];
-        }
-        _expansionBackgroundAnimated = _expansionBackground;
-        _expansionBackground = nil;
         _expandedButton = nil;
         if (_backgroundColorCopy) {
-            _expansionBackgroundAnimated.backgroundColor = _backgroundColorCopy;
-            _expandedButtonAnimated.backgroundColor = _backgroundColorCopy;
+            _expansionBackground.backgroundColor = _backgroundColorCopy;
+            _expansionButton.backgroundColor = _backgroundColorCopy;
             _backgroundColorCopy = nil;
         }
-        CGFloat duration = _fromLeft ? _cell.leftExpansion.animationDuration : _cell.rightExpansion.animationDuration;
-        [UIView animateWithDuration: animated ? duration : 0.0 delay:0 options:UIViewAnimationOptionBeginFromCurrentState animations:^{
-            self->_container.frame = self.bounds;
-            if (self->_expansionLayout == MGSwipeExpansionLayoutCenter) {
-                self->_expandedButtonAnimated.frame = self->_expandedButtonBoundsCopy;
-            }
-            [self resetButtons];
-            self->_expansionBackgroundAnimated.frame = [self expansionBackgroundRect:self->_expandedButtonAnimated];
-        } completion:^(BOOL finished) {
-            [self->_expansionBackgroundAnimated removeFromSuperview];
-        }];
+        [self animateExpansionTo:0 animated:animated];
     }
-    else if (_expansionBackground) {
-        [_expansionBackground removeFromSuperview];
-        _expansionBackground = nil;
+    else if (_expansionButton && !animated) {
+        [self animateExpansionTo:0 animated:NO];
     }
 }
 
@@ -337,7 +708,7 @@
     }
 #pragma clang diagnostic pop
     
-    if (_cell.delegate && [_cell.delegate respondsToSelector:@selector(swipeTableCell:tappedButtonAtIndex:direction:fromExpansion:)]) {
+    if ([_cell delegateResponds:MGSwipeDelegateCapabilityTappedButton]) {
         NSInteger index = [_buttons indexOfObject:sender];
         if (!_fromLeft) {
             index = _buttons.count - index - 1; //right buttons are reversed
@@ -363,20 +734,66 @@
 }
 
 
+#pragma mark Virtualization
+
+static inline MGSwipeLayoutTransition mgLayoutTransition(MGSwipeTransition mode)
+{
+    switch (mode) {
+        case MGSwipeTransitionBorder: return MGSwipeLayoutTransitionBorder;
+        case MGSwipeTransitionStatic: return MGSwipeLayoutTransitionStatic;
+        case MGSwipeTransitionDrag: return MGSwipeLayoutTransitionDrag;
+        case MGSwipeTransitionClipCenter: return MGSwipeLayoutTransitionClipCenter;
+        case MGSwipeTransitionRotate3D: return MGSwipeLayoutTransitionRotate3D;
+    }
+    return MGSwipeLayoutTransitionBorder;
+}
+
+/**
+ * Keeps as subviews only the buttons that will be visible through the superview at the transition t.
+ * Only the buttons entering or leaving the range are touched. The search is logarithmic when all the buttons have the
+ * same width and linear otherwise, e.g. when expandLastButtonBySafeAreaInsets widens the edge button.
+ */
+-(void) attachVisibleButtons:(MGSwipeTransition) mode percent:(CGFloat) t
+{
+    CGRect visible = self.superview ? CGRectIntersection(self.bounds, [self convertRect:self.superview.bounds fromView:self.superview]) : self.bounds;
+    if (CGRectIsNull(visible)) {
+        visible = CGRectZero;
+    }
+    size_t first = 0, end = 0;
+    mgSwipeButtonsLayoutVisibleRange(&_layout, mgLayoutTransition(mode), t, self.bounds.size.width, _fromLeft,
+                                     CGRectGetMinX(visible), CGRectGetMaxX(visible), &first, &end);
+    [self attachButtonsFrom:first to:end];
+}
+
+-(void) attachButtonsFrom:(NSUInteger) first to:(NSUInteger) end
+{
+    if (first == _attachedFirst && end == _attachedEnd) {
+        return;
+    }
+    for (NSUInteger i = _attachedFirst; i < _attachedEnd; ++i) {
+        if (i < first || i >= end) {
+            [[_buttons objectAtIndex:i] removeFromSuperview];
+        }
+    }
+    //same stacking as the full strip: left buttons stack over the next ones, right buttons over the previous ones.
+    //buttons below are attached first, so the index is the number of buttons below in the range
+    for (NSUInteger n = 0; n < end - first; ++n) {
+        const NSUInteger i = _fromLeft ? end - 1 - n : first + n;
+        UIView * button = [_buttons objectAtIndex:i];
+        if (button.superview != _container) {
+            [_container insertSubview:button atIndex:n];
+        }
+    }
+    _attachedFirst = first;
+    _attachedEnd = end;
+}
+
 #pragma mark Transitions
 
 -(void) transitionStatic:(CGFloat) t
 {
-    const CGFloat dx = self.bounds.size.width * (1.0 - t);
-    CGFloat offsetX = 0;
-    
-    UIView* lastButton = [_buttons lastObject];
-    for (UIView *button in _buttons) {
-        CGRect frame = button.frame;
-        frame.origin.x = offsetX + (_fromLeft ? dx : -dx);
-        button.frame = frame;
-        offsetX += frame.size.width + (button == lastButton ? 0 : _buttonsDistance);
-    }
+    mgSwipeButtonsLayoutTransitionRange(&_layout, MGSwipeLayoutTransitionStatic, t, self.bounds.size.width, _fromLeft, _attachedFirst, _attachedEnd);
+    [self applyLayoutPositions];
 }
 
 -(void) transitionDrag:(CGFloat) t
@@ -386,41 +803,47 @@
 
 -(void) transitionClip:(CGFloat) t
 {
-    CGFloat selfWidth = self.bounds.size.width;
-    CGFloat offsetX = 0;
-    
-    UIView* lastButton = [_buttons lastObject];
-    for (UIView *button in _buttons) {
-        CGRect frame = button.frame;
-        CGFloat dx = roundf(frame.size.width * 0.5 * (1.0 - t)) ;
-        frame.origin.x = _fromLeft ? (selfWidth - frame.size.width - offsetX) * (1.0 - t) + offsetX + dx : offsetX * t - dx;
-        button.frame = frame;
+    mgSwipeButtonsLayoutTransitionRange(&_layout, MGSwipeLayoutTransitionClipCenter, t, self.bounds.size.width, _fromLeft, _attachedFirst, _attachedEnd);
+    [self applyLayoutPositions];
+    if (_buttons.count <= 1) {
+        return;
+    }
+    if (!_clipMasks) {
+        //one mask per button for the life of the view, the transition only updates their geometry
+        static NSDictionary * disabledActions = nil;
+        static dispatch_once_t onceToken;
+        dispatch_once(&onceToken, ^{
+            disabledActions = @{@"bounds": [NSNull null], @"position": [NSNull null]};
+        });
+        _clipMasks = [NSMutableArray arrayWithCapacity:_buttons.count];
+        for (NSUInteger i = 0; i < _buttons.count; ++i) {
+            CALayer * maskLayer = [CALayer layer];
+            maskLayer.backgroundColor = [UIColor blackColor].CGColor;
+            maskLayer.actions = disabledActions;
+            [_clipMasks addObject:maskLayer];
+        }
+        _transitionMaskLayers += _buttons.count;
+    }
 
-        if (_buttons.count > 1) {
-            CAShapeLayer *maskLayer = [CAShapeLayer new];
-            CGRect maskRect = CGRectMake(dx - 0.5, 0, frame.size.width - 2 * dx + 1.5, frame.size.height);
-            CGPathRef path = CGPathCreateWithRect(maskRect, NULL);
-            maskLayer.path = path;
-            CGPathRelease(path);
+    for (NSUInteger index = _attachedFirst; index < _attachedEnd; ++index) {
+        UIView * button = [_buttons objectAtIndex:index];
+        const CGFloat dx = _layout.clips[index];
+        const CGFloat width = _layout.widths[index];
+        CALayer * maskLayer = [_clipMasks objectAtIndex:index];
+        CGRect maskRect = CGRectMake(dx - 0.5, 0, width - 2 * dx + 1.5, button.bounds.size.height);
+        if (!CGRectEqualToRect(maskLayer.frame, maskRect)) {
+            maskLayer.frame = maskRect;
+        }
+        if (button.layer.mask != maskLayer) {
             button.layer.mask = maskLayer;
         }
-
-        offsetX += frame.size.width + (button == lastButton ? 0 : _buttonsDistance);
     }
 }
 
 -(void) transtitionFloatBorder:(CGFloat) t
 {
-    CGFloat selfWidth = self.bounds.size.width;
-    CGFloat offsetX = 0;
-    
-    UIView* lastButton = [_buttons lastObject];
-    for (UIView *button in _buttons) {
-        CGRect frame = button.frame;
-        frame.origin.x = _fromLeft ? (selfWidth - frame.size.width - offsetX) * (1.0 - t) + offsetX : offsetX * t;
-        button.frame = frame;
-        offsetX += frame.size.width + (button == lastButton ? 0 : _buttonsDistance);
-    }
+    mgSwipeButtonsLayoutTransitionRange(&_layout, MGSwipeLayoutTransitionBorder, t, self.bounds.size.width, _fromLeft, _attachedFirst, _attachedEnd);
+    [self applyLayoutPositions];
 }
 
 -(void) transition3D:(CGFloat) t
@@ -439,6 +862,9 @@
 
 -(void) transition:(MGSwipeTransition) mode percent:(CGFloat) t
 {
+    if (_virtualizesButtons && !_expansionButton) {
+        [self attachVisibleButtons:mode percent:t];
+    }
     switch (mode) {
         case MGSwipeTransitionStatic: [self transitionStatic:t]; break;
         case MGSwipeTransitionDrag: [self transitionDrag:t]; break;
@@ -446,15 +872,74 @@
         case MGSwipeTransitionBorder: [self transtitionFloatBorder:t]; break;
         case MGSwipeTransitionRotate3D: [self transition3D:t]; break;
     }
-    if (_expandedButtonAnimated && _expansionBackgroundAnimated) {
-        _expansionBackgroundAnimated.frame = [self expansionBackgroundRect:_expandedButtonAnimated];
+    _lastTransition = mode;
+    _lastTransitionPercent = t;
+    _hasLastTransition = YES;
+    if (_expansionButton) { //collapsing, the expansion state owns the button and the background
+        [self applyExpansionState];
     }
 }
 
 @end
 
 #pragma mark Settings Classes
+
+@interface MGSwipeSettings () <NSCopying>
+/** Settings shared by all the cells until a cell customizes them. Never mutated */
++(instancetype) sharedDefaultSettings;
+/** YES once any value, or a value of its animations, is set after init. E.g. the delegate customized a copy handed to it */
+@property (nonatomic, readonly) BOOL customized;
+@end
+
+@interface MGSwipeExpansionSettings () <NSCopying>
++(instancetype) sharedDefaultSettings;
+@property (nonatomic, readonly) BOOL customized;
+@end
+
+@interface MGSwipeAnimation () <NSCopying>
+/** YES once any value is changed after init */
+@property (nonatomic, readonly) BOOL customized;
+@end
+
+/** Animations are created on first access, a missing one has the default values */
+static BOOL mgSwipeAnimationIsDefault(MGSwipeAnimation * animation)
+{
+    return !animation || (animation.class == [MGSwipeAnimation class] && !animation.customized);
+}
+
+/** Property setter that marks the settings as customized. Every settable property of the settings classes uses one */
+#define MG_CUSTOMIZING_SETTER(type, name, Name) \
+-(void) set##Name:(type) name \
+{ \
+    _##name = name; \
+    _customized = YES; \
+}
+
+/** Subclasses can keep state of their own that a copy would lose, they are shared instead */
+static MGSwipeAnimation * mgSwipeAnimationCopy(MGSwipeAnimation * animation)
+{
+    return animation.class == [MGSwipeAnimation class] ? [animation copy] : animation;
+}
+
 @implementation MGSwipeSettings
+{
+    BOOL _customized;
+}
+
++(instancetype) sharedDefaultSettings
+{
+    static MGSwipeSettings * settings = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        settings = [[MGSwipeSettings alloc] init];
+        //created up front, the lazy getters must not write into the shared instance
+        [settings showAnimation];
+        [settings hideAnimation];
+        [settings stretchAnimation];
+    });
+    return settings;
+}
+
 -(instancetype) init
 {
     if (self = [super init]) {
@@ -465,37 +950,175 @@
         self.keepButtonsSwiped = YES;
         self.enableSwipeBounces = YES;
         self.swipeBounceRate = 1.0;
-        self.showAnimation = [[MGSwipeAnimation alloc] init];
-        self.hideAnimation = [[MGSwipeAnimation alloc] init];
-        self.stretchAnimation = [[MGSwipeAnimation alloc] init];
+        self.animationMode = MGSwipeAnimationModeTimed;
+        self.springResponse = 0.3;
+        self.adaptsFrameRateToPowerState = YES;
+        _customized = NO; //the values above are the defaults
+        //animations are allocated on first access
+        mgMetricsCountSettingsAllocation(self);
     }
     return self;
 }
 
+-(BOOL) customized
+{
+    return _customized || !mgSwipeAnimationIsDefault(_showAnimation) || !mgSwipeAnimationIsDefault(_hideAnimation) ||
+        !mgSwipeAnimationIsDefault(_stretchAnimation);
+}
+
+@synthesize showAnimation = _showAnimation, hideAnimation = _hideAnimation, stretchAnimation = _stretchAnimation;
+
+MG_CUSTOMIZING_SETTER(MGSwipeTransition, transition, Transition)
+MG_CUSTOMIZING_SETTER(CGFloat, threshold, Threshold)
+MG_CUSTOMIZING_SETTER(CGFloat, offset, Offset)
+MG_CUSTOMIZING_SETTER(CGFloat, topMargin, TopMargin)
+MG_CUSTOMIZING_SETTER(CGFloat, bottomMargin, BottomMargin)
+MG_CUSTOMIZING_SETTER(CGFloat, buttonsDistance, ButtonsDistance)
+MG_CUSTOMIZING_SETTER(BOOL, expandLastButtonBySafeAreaInsets, ExpandLastButtonBySafeAreaInsets)
+MG_CUSTOMIZING_SETTER(MGSwipeAnimation *, showAnimation, ShowAnimation)
+MG_CUSTOMIZING_SETTER(MGSwipeAnimation *, hideAnimation, HideAnimation)
+MG_CUSTOMIZING_SETTER(MGSwipeAnimation *, stretchAnimation, StretchAnimation)
+MG_CUSTOMIZING_SETTER(MGSwipeAnimationMode, animationMode, AnimationMode)
+MG_CUSTOMIZING_SETTER(CGFloat, springResponse, SpringResponse)
+MG_CUSTOMIZING_SETTER(BOOL, keepButtonsSwiped, KeepButtonsSwiped)
+MG_CUSTOMIZING_SETTER(BOOL, onlySwipeButtons, OnlySwipeButtons)
+MG_CUSTOMIZING_SETTER(BOOL, enableSwipeBounces, EnableSwipeBounces)
+MG_CUSTOMIZING_SETTER(CGFloat, swipeBounceRate, SwipeBounceRate)
+MG_CUSTOMIZING_SETTER(BOOL, allowsButtonsWithDifferentWidth, AllowsButtonsWithDifferentWidth)
+MG_CUSTOMIZING_SETTER(BOOL, prerendersDescriptorButtons, PrerendersDescriptorButtons)
+MG_CUSTOMIZING_SETTER(BOOL, virtualizesButtons, VirtualizesButtons)
+MG_CUSTOMIZING_SETTER(BOOL, adaptsFrameRateToPowerState, AdaptsFrameRateToPowerState)
+MG_CUSTOMIZING_SETTER(CGFloat, minimumOffsetDelta, MinimumOffsetDelta)
+
+-(id) copyWithZone:(NSZone *) zone
+{
+    MGSwipeSettings * copy = [[self.class allocWithZone:zone] init];
+    copy->_transition = _transition;
+    copy->_threshold = _threshold;
+    copy->_offset = _offset;
+    copy->_topMargin = _topMargin;
+    copy->_bottomMargin = _bottomMargin;
+    copy->_buttonsDistance = _buttonsDistance;
+    copy->_expandLastButtonBySafeAreaInsets = _expandLastButtonBySafeAreaInsets;
+    copy->_showAnimation = mgSwipeAnimationCopy(_showAnimation);
+    copy->_hideAnimation = mgSwipeAnimationCopy(_hideAnimation);
+    copy->_stretchAnimation = mgSwipeAnimationCopy(_stretchAnimation);
+    copy->_animationMode = _animationMode;
+    copy->_springResponse = _springResponse;
+    copy->_keepButtonsSwiped = _keepButtonsSwiped;
+    copy->_onlySwipeButtons = _onlySwipeButtons;
+    copy->_enableSwipeBounces = _enableSwipeBounces;
+    copy->_swipeBounceRate = _swipeBounceRate;
+    copy->_allowsButtonsWithDifferentWidth = _allowsButtonsWithDifferentWidth;
+    copy->_prerendersDescriptorButtons = _prerendersDescriptorButtons;
+    copy->_virtualizesButtons = _virtualizesButtons;
+    copy->_adaptsFrameRateToPowerState = _adaptsFrameRateToPowerState;
+    copy->_minimumOffsetDelta = _minimumOffsetDelta;
+    copy->_customized = _customized;
+    return copy;
+}
+
+-(MGSwipeAnimation *) showAnimation
+{
+    if (!_showAnimation) {
+        _showAnimation = [[MGSwipeAnimation alloc] init];
+    }
+    return _showAnimation;
+}
+
+-(MGSwipeAnimation *) hideAnimation
+{
+    if (!_hideAnimation) {
+        _hideAnimation = [[MGSwipeAnimation alloc] init];
+    }
+    return _hideAnimation;
+}
+
+-(MGSwipeAnimation *) stretchAnimation
+{
+    if (!_stretchAnimation) {
+        _stretchAnimation = [[MGSwipeAnimation alloc] init];
+    }
+    return _stretchAnimation;
+}
+
 -(void) setAnimationDuration:(CGFloat)duration
 {
-    _showAnimation.duration = duration;
-    _hideAnimation.duration = duration;
-    _stretchAnimation.duration = duration;
+    self.showAnimation.duration = duration;
+    self.hideAnimation.duration = duration;
+    self.stretchAnimation.duration = duration;
 }
 
 -(CGFloat) animationDuration {
-    return _showAnimation.duration;
+    return self.showAnimation.duration;
 }
 
 @end
 
 @implementation MGSwipeExpansionSettings
--(instancetype) init
 {
-    if (self = [super init]) {
-        self.buttonIndex = -1;
+    BOOL _customized;
+}
+
++(instancetype) sharedDefaultSettings
+{
+    static MGSwipeExpansionSettings * settings = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        settings = [[MGSwipeExpansionSettings alloc] init];
+        [settings triggerAnimation]; //created up front, see MGSwipeSettings
+    });
+    return settings;
+}
+
+-(instancetype) init
+{
+    if (self = [super init]) {
+        self.buttonIndex = -1;
         self.threshold = 1.3;
         self.animationDuration = 0.2;
-        self.triggerAnimation = [[MGSwipeAnimation alloc] init];
+        _customized = NO; //the values above are the defaults
+        mgMetricsCountSettingsAllocation(self);
     }
     return self;
 }
+
+-(BOOL) customized
+{
+    return _customized || !mgSwipeAnimationIsDefault(_triggerAnimation);
+}
+
+@synthesize triggerAnimation = _triggerAnimation;
+
+MG_CUSTOMIZING_SETTER(NSInteger, buttonIndex, ButtonIndex)
+MG_CUSTOMIZING_SETTER(BOOL, fillOnTrigger, FillOnTrigger)
+MG_CUSTOMIZING_SETTER(CGFloat, threshold, Threshold)
+MG_CUSTOMIZING_SETTER(UIColor *, expansionColor, ExpansionColor)
+MG_CUSTOMIZING_SETTER(MGSwipeExpansionLayout, expansionLayout, ExpansionLayout)
+MG_CUSTOMIZING_SETTER(MGSwipeAnimation *, triggerAnimation, TriggerAnimation)
+MG_CUSTOMIZING_SETTER(CGFloat, animationDuration, AnimationDuration)
+
+-(id) copyWithZone:(NSZone *) zone
+{
+    MGSwipeExpansionSettings * copy = [[self.class allocWithZone:zone] init];
+    copy->_buttonIndex = _buttonIndex;
+    copy->_fillOnTrigger = _fillOnTrigger;
+    copy->_threshold = _threshold;
+    copy->_expansionColor = _expansionColor;
+    copy->_expansionLayout = _expansionLayout;
+    copy->_triggerAnimation = mgSwipeAnimationCopy(_triggerAnimation);
+    copy->_animationDuration = _animationDuration;
+    copy->_customized = _customized;
+    return copy;
+}
+
+-(MGSwipeAnimation *) triggerAnimation
+{
+    if (!_triggerAnimation) {
+        _triggerAnimation = [[MGSwipeAnimation alloc] init];
+    }
+    return _triggerAnimation;
+}
 @end
 
 @interface MGSwipeAnimationData : NSObject
@@ -511,106 +1134,636 @@
 @end
 
 
-#pragma mark Easing Functions and MGSwipeAnimation
+#pragma mark MGSwipeAnimation
 
-static inline CGFloat mgEaseLinear(CGFloat t, CGFloat b, CGFloat c) {
-    return c*t + b;
+static MGEasingFunction mgEasingFunctionFor(MGSwipeEasingFunction easingFunction)
+{
+    switch (easingFunction) {
+        case MGSwipeEasingFunctionLinear: return mgEaseLinear;
+        case MGSwipeEasingFunctionQuadIn: return mgEaseInQuad;
+        case MGSwipeEasingFunctionQuadOut: return mgEaseOutQuad;
+        case MGSwipeEasingFunctionQuadInOut: return mgEaseInOutQuad;
+        case MGSwipeEasingFunctionCubicIn: return mgEaseInCubic;
+        default:
+        case MGSwipeEasingFunctionCubicOut: return mgEaseOutCubic;
+        case MGSwipeEasingFunctionCubicInOut: return mgEaseInOutCubic;
+        case MGSwipeEasingFunctionBounceIn: return mgEaseInBounce;
+        case MGSwipeEasingFunctionBounceOut: return mgEaseOutBounce;
+        case MGSwipeEasingFunctionBounceInOut: return mgEaseInOutBounce;
+    }
 }
 
-static inline CGFloat mgEaseInQuad(CGFloat t, CGFloat b, CGFloat c) {
-    return c*t*t + b;
+@implementation MGSwipeAnimation
+{
+    MGEasingCurve _curve; //resolved when the easing function changes, not on every tick
 }
-static inline CGFloat mgEaseOutQuad(CGFloat t, CGFloat b, CGFloat c) {
-    return -c*t*(t-2) + b;
+
+-(instancetype) init {
+    if (self = [super init]) {
+        _duration = 0.3;
+        self.easingFunction = MGSwipeEasingFunctionCubicOut;
+        _customized = NO;
+        mgMetricsCountSettingsAllocation(self);
+    }
+    return self;
 }
-static inline CGFloat mgEaseInOutQuad(CGFloat t, CGFloat b, CGFloat c) {
-    if ((t*=2) < 1) return c/2*t*t + b;
-    --t;
-    return -c/2 * (t*(t-2) - 1) + b;
+
+-(id) copyWithZone:(NSZone *) zone
+{
+    MGSwipeAnimation * copy = [[self.class allocWithZone:zone] init];
+    copy->_duration = _duration;
+    copy->_easingFunction = _easingFunction;
+    copy->_frameRateRange = _frameRateRange;
+    copy->_customized = _customized;
+    mgEasingCurveCopy(&copy->_curve, &_curve);
+    return copy;
 }
-static inline CGFloat mgEaseInCubic(CGFloat t, CGFloat b, CGFloat c) {
-    return c*t*t*t + b;
+
+-(void) setDuration:(CGFloat) duration
+{
+    _duration = duration;
+    _customized = YES;
 }
-static inline CGFloat mgEaseOutCubic(CGFloat t, CGFloat b, CGFloat c) {
-    --t;
-    return c*(t*t*t + 1) + b;
+
+-(void) setFrameRateRange:(MGSwipeFrameRateRange) frameRateRange
+{
+    _frameRateRange = frameRateRange;
+    _customized = YES;
 }
-static inline CGFloat mgEaseInOutCubic(CGFloat t, CGFloat b, CGFloat c) {
-    if ((t*=2) < 1) return c/2*t*t*t + b;
-    t-=2;
-    return c/2*(t*t*t + 2) + b;
+
+-(void) dealloc
+{
+    mgEasingCurveFree(&_curve);
 }
-static inline CGFloat mgEaseOutBounce(CGFloat t, CGFloat b, CGFloat c) {
-    if (t < (1/2.75)) {
-        return c*(7.5625*t*t) + b;
-    } else if (t < (2/2.75)) {
-        t-=(1.5/2.75);
-        return c*(7.5625*t*t + .75) + b;
-    } else if (t < (2.5/2.75)) {
-        t-=(2.25/2.75);
-        return c*(7.5625*t*t + .9375) + b;
-    } else {
-        t-=(2.625/2.75);
-        return c*(7.5625*t*t + .984375) + b;
+
+-(void) setEasingFunction:(MGSwipeEasingFunction)easingFunction
+{
+    _easingFunction = easingFunction;
+    _customized = YES;
+    if (easingFunction == MGSwipeEasingFunctionCubicBezier) {
+        [self setCubicBezierControlPoint1:CGPointMake(0.25, 0.1) controlPoint2:CGPointMake(0.25, 1.0)];
     }
-};
-static inline CGFloat mgEaseInBounce(CGFloat t, CGFloat b, CGFloat c) {
-    return c - mgEaseOutBounce (1.0 -t, 0, c) + b;
-};
+    else if (easingFunction == MGSwipeEasingFunctionSpring) {
+        [self setSpringDamping:0.7 initialVelocity:0];
+    }
+    else {
+        mgEasingCurveSetFunction(&_curve, mgEasingFunctionFor(easingFunction));
+    }
+}
 
-static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
-    if (t < 0.5) return mgEaseInBounce (t*2, 0, c) * .5 + b;
-    return mgEaseOutBounce (1.0 - t*2, 0, c) * .5 + c*.5 + b;
-};
+-(void) setCubicBezierControlPoint1:(CGPoint) point1 controlPoint2:(CGPoint) point2
+{
+    _easingFunction = MGSwipeEasingFunctionCubicBezier;
+    _customized = YES;
+    mgEasingCurveSetCubicBezier(&_curve, point1.x, point1.y, point2.x, point2.y);
+}
 
-@implementation MGSwipeAnimation
+-(void) setSpringDamping:(CGFloat) damping initialVelocity:(CGFloat) velocity
+{
+    _easingFunction = MGSwipeEasingFunctionSpring;
+    _customized = YES;
+    mgEasingCurveSetSpring(&_curve, damping, velocity);
+}
 
--(instancetype) init {
+-(CGFloat) value:(CGFloat)elapsed duration:(CGFloat)duration from:(CGFloat)from to:(CGFloat)to
+{
+    return mgEasingCurveValue(&_curve, elapsed, duration, from, to);
+}
+
+-(void) values:(CGFloat *) values elapsed:(const CGFloat *) elapsed from:(const CGFloat *) from to:(const CGFloat *) to count:(NSUInteger) count duration:(CGFloat) duration
+{
+    static IMP baseValueIMP = NULL;
+    if (!baseValueIMP) {
+        baseValueIMP = [MGSwipeAnimation instanceMethodForSelector:@selector(value:duration:from:to:)];
+    }
+#if CGFLOAT_IS_DOUBLE
+    if ([self methodForSelector:@selector(value:duration:from:to:)] == baseValueIMP) {
+        mgEasingCurveValues(&_curve, elapsed, from, to, values, count, duration);
+        return;
+    }
+#endif
+    //custom easing implemented by a subclass or 32 bit CGFloat
+    for (NSUInteger i = 0; i < count; ++i) {
+        values[i] = [self value:elapsed[i] duration:duration from:from[i] to:to[i]];
+    }
+}
+
+@end
+
+#pragma mark Shared Animation Scheduler Implementation
+
+static void mgSchedulerTick(void * client, double timestamp)
+{
+    [(__bridge id<MGSwipeAnimationClient>) client advanceAnimation:timestamp];
+}
+
+static void mgSchedulerRelease(void * client)
+{
+    CFRelease(client);
+}
+
+@implementation MGSwipeAnimationScheduler
+{
+    MGAnimationTicker _ticker;
+    CADisplayLink * _displayLink;
+    CFTimeInterval _lastTimestamp;
+    BOOL _manualClock;
+}
+
++(instancetype) sharedScheduler
+{
+    static MGSwipeAnimationScheduler * scheduler = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        scheduler = [[MGSwipeAnimationScheduler alloc] init];
+    });
+    return scheduler;
+}
+
+-(instancetype) init
+{
     if (self = [super init]) {
-        _duration = 0.3;
-        _easingFunction = MGSwipeEasingFunctionCubicOut;
+        mgAnimationTickerInit(&_ticker, mgSchedulerTick, mgSchedulerRelease);
+        [self updatePowerState];
+        if (@available(iOS 10.3, *)) {
+            _displayMaximumFrameRate = [UIScreen mainScreen].maximumFramesPerSecond;
+        }
+        NSNotificationCenter * center = [NSNotificationCenter defaultCenter];
+        [center addObserver:self selector:@selector(powerStateDidChange:) name:NSProcessInfoPowerStateDidChangeNotification object:nil];
+        if (@available(iOS 11, *)) {
+            [center addObserver:self selector:@selector(powerStateDidChange:) name:NSProcessInfoThermalStateDidChangeNotification object:nil];
+        }
     }
     return self;
 }
 
--(CGFloat) value:(CGFloat)elapsed duration:(CGFloat)duration from:(CGFloat)from to:(CGFloat)to
+-(instancetype) initWithManualClock
 {
-    CGFloat t = MIN(elapsed/duration, 1.0f);
-    if (t == 1.0) {
-        return to; //precise last value
-    }
-    CGFloat (*easingFunction)(CGFloat t, CGFloat b, CGFloat c) = 0;
-    switch (_easingFunction) {
-        case MGSwipeEasingFunctionLinear: easingFunction = mgEaseLinear;break;
-        case MGSwipeEasingFunctionQuadIn: easingFunction = mgEaseInQuad;break;
-        case MGSwipeEasingFunctionQuadOut: easingFunction = mgEaseOutQuad;break;
-        case MGSwipeEasingFunctionQuadInOut: easingFunction = mgEaseInOutQuad;break;
-        case MGSwipeEasingFunctionCubicIn: easingFunction = mgEaseInCubic;break;
-        default:
-        case MGSwipeEasingFunctionCubicOut: easingFunction = mgEaseOutCubic;break;
-        case MGSwipeEasingFunctionCubicInOut: easingFunction = mgEaseInOutCubic;break;
-        case MGSwipeEasingFunctionBounceIn: easingFunction = mgEaseInBounce;break;
-        case MGSwipeEasingFunctionBounceOut: easingFunction = mgEaseOutBounce;break;
-        case MGSwipeEasingFunctionBounceInOut: easingFunction = mgEaseInOutBounce;break;
+    if (self = [self init]) {
+        _manualClock = YES;
+        //the power signals are simulated too
+        [[NSNotificationCenter defaultCenter] removeObserver:self];
+    }
+    return self;
+}
+
+-(void) dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    mgAnimationTickerFree(&_ticker);
+}
+
+-(NSUInteger) activeCount
+{
+    return _ticker.active;
+}
+
+-(void) addClient:(id<MGSwipeAnimationClient>) client
+{
+    void * retained = (void *) CFBridgingRetain(client);
+    if (!mgAnimationTickerAdd(&_ticker, retained)) {
+        CFRelease(retained);
+        return;
+    }
+    if (_manualClock) {
+        return;
+    }
+    if (!_displayLink) {
+        _displayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(displayLinkTick:)];
+        [self applyFrameRateRange];
+        [_displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+    }
+    _displayLink.paused = NO;
+}
+
+-(void) addClient:(id<MGSwipeAnimationClient>) client frameRateRange:(MGSwipeFrameRateRange) range adaptsToPowerState:(BOOL) adapts
+{
+    [self addClient:client];
+    [self setFrameRateRange:range adaptsToPowerState:adapts forClient:client];
+}
+
+-(void) removeClient:(id<MGSwipeAnimationClient>) client
+{
+    //released by the ticker, at the end of the tick when it's ticking
+    if (!mgAnimationTickerRemove(&_ticker, (__bridge void *) client) || _ticker.ticking) {
+        return;
+    }
+    if (_ticker.active == 0) {
+        [self pause];
+    }
+}
+
+-(void) pause
+{
+    _displayLink.paused = YES;
+    _lastTimestamp = 0;
+}
+
+#pragma mark Frame Pacing
+
+-(void) setFrameRateRange:(MGSwipeFrameRateRange) range adaptsToPowerState:(BOOL) adapts forClient:(id<MGSwipeAnimationClient>) client
+{
+    MGFrameRateRange clientRange = {range.minimum, range.maximum, range.preferred};
+    mgAnimationTickerSetFrameRateRange(&_ticker, (__bridge void *) client, clientRange, adapts);
+}
+
+-(MGFrameRateRange) frameRateRange
+{
+    [self updateFrameRateRangeIfNeeded];
+    return _frameRateRange;
+}
+
+/** The union is computed once per tick at most, and only after the clients or the power state changed */
+-(void) updateFrameRateRangeIfNeeded
+{
+    if (!_ticker.rangeChanged) {
+        return;
+    }
+    MGFrameRateRange range = mgAnimationTickerFrameRateRange(&_ticker, _lowPowerMode, _thermalState);
+    range = mgFrameRateRangeNormalize(range, _displayMaximumFrameRate);
+    if (range.minimum != _frameRateRange.minimum || range.maximum != _frameRateRange.maximum || range.preferred != _frameRateRange.preferred) {
+        _frameRateRange = range;
+        [self applyFrameRateRange];
+    }
+}
+
+-(void) applyFrameRateRange
+{
+    if (!_displayLink) {
+        return;
+    }
+    if (@available(iOS 15, *)) {
+        _displayLink.preferredFrameRateRange = CAFrameRateRangeMake(_frameRateRange.minimum, _frameRateRange.maximum, _frameRateRange.preferred);
+    }
+    else if (@available(iOS 10, *)) {
+        _displayLink.preferredFramesPerSecond = _frameRateRange.preferred > 0 ? _frameRateRange.preferred : _frameRateRange.maximum;
+    }
+}
+
+-(void) updatePowerState
+{
+    NSProcessInfo * processInfo = [NSProcessInfo processInfo];
+    _lowPowerMode = processInfo.lowPowerModeEnabled;
+    if (@available(iOS 11, *)) {
+        _thermalState = (MGThermalState) processInfo.thermalState;
+    }
+}
+
+-(void) powerStateDidChange:(NSNotification *) notification
+{
+    //posted on arbitrary threads
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [self updatePowerState];
+        self->_ticker.rangeChanged = true;
+    });
+}
+
+-(void) setLowPowerMode:(BOOL) lowPowerMode
+{
+    _lowPowerMode = lowPowerMode;
+    _ticker.rangeChanged = true;
+}
+
+-(void) setThermalState:(MGThermalState) thermalState
+{
+    _thermalState = thermalState;
+    _ticker.rangeChanged = true;
+}
+
+-(void) setDisplayMaximumFrameRate:(double) displayMaximumFrameRate
+{
+    _displayMaximumFrameRate = displayMaximumFrameRate;
+    _ticker.rangeChanged = true;
+}
+
+#pragma mark Ticks
+
+-(void) displayLinkTick:(CADisplayLink *) displayLink
+{
+    //the expected interval of the requested frame rate, duration is the display refresh interval
+    CFTimeInterval interval = displayLink.duration;
+    if (@available(iOS 10, *)) {
+        interval = displayLink.targetTimestamp - displayLink.timestamp;
+    }
+    if (mgMetricsSink && _lastTimestamp > 0 && interval > 0) {
+        double skipped = round((displayLink.timestamp - _lastTimestamp) / interval) - 1;
+        if (skipped > 0) {
+            mgMetricsRecord(MGSwipeMetricDroppedFrames, skipped);
+        }
+    }
+    _lastTimestamp = displayLink.timestamp;
+    [self advanceToTime:displayLink.timestamp];
+}
+
+-(void) advanceToTime:(CFTimeInterval) timestamp
+{
+    //the display link runs at the requested rates, the manual clock at the rate of its caller
+    [self updateFrameRateRangeIfNeeded];
+    mgAnimationTickerAdvance(&_ticker, timestamp);
+    if (_ticker.active == 0) {
+        [self pause];
+    }
+}
+
+@end
+
+#pragma mark Event Queue
+
+/** Queues the swipe events of a cell and delivers them in a batch on the next animation frame */
+@interface MGSwipeEventQueue : NSObject <MGSwipeAnimationClient>
+-(instancetype) initWithCell:(MGSwipeTableCell *) cell;
+-(void) pushEvent:(MGSwipeEventRecord) record;
+-(void) discardEvents;
+@end
+
+@implementation MGSwipeEventQueue
+{
+    __weak MGSwipeTableCell * _cell;
+    MGSwipeEventRing _ring;
+    MGSwipeAnimationScheduler * _scheduler; //scheduler delivering the queued events, nil if none are scheduled
+}
+
+-(instancetype) initWithCell:(MGSwipeTableCell *) cell
+{
+    if (self = [super init]) {
+        _cell = cell;
+    }
+    return self;
+}
+
+-(void) pushEvent:(MGSwipeEventRecord) record
+{
+    mgSwipeEventRingPush(&_ring, record);
+    if (!_scheduler) {
+        _scheduler = _cell.animationScheduler ?: [MGSwipeAnimationScheduler sharedScheduler];
+        [_scheduler addClient:self];
+    }
+}
+
+-(void) discardEvents
+{
+    _ring.head = _ring.count = 0;
+    [_scheduler removeClient:self];
+    _scheduler = nil;
+}
+
+-(void) advanceAnimation:(CFTimeInterval) timestamp
+{
+    MGSwipeEventRecord records[MG_EVENT_RING_CAPACITY];
+    NSUInteger count = mgSwipeEventRingDrain(&_ring, records, MG_EVENT_RING_CAPACITY);
+    [_scheduler removeClient:self];
+    _scheduler = nil;
+    //the delegate might push new events, they are delivered on the next frame
+    [_cell deliverSwipeEvents:records count:count];
+}
+
+@end
+
+#pragma mark Buttons Pool
+
+/** Prebuilt buttons view and the settings configured by the delegate for it */
+@interface MGSwipeButtonsPoolEntry : NSObject
+@property (nonatomic, strong) MGSwipeButtonsView * buttonsView;
+@property (nonatomic, copy) NSArray * buttons;
+@property (nonatomic, strong) MGSwipeSettings * settings;
+@property (nonatomic, strong) MGSwipeExpansionSettings * expansion;
+@end
+
+@implementation MGSwipeButtonsPoolEntry
+@end
+
+@interface MGSwipeButtonsPool ()
+-(MGSwipeButtonsPoolEntry *) checkoutButtonsWithIdentifier:(NSString *) identifier direction:(MGSwipeDirection) direction;
+-(void) returnButtons:(MGSwipeButtonsPoolEntry *) entry identifier:(NSString *) identifier direction:(MGSwipeDirection) direction;
+@end
+
+@implementation MGSwipeButtonsPool
+{
+    NSMutableDictionary<NSString *, NSMutableArray<MGSwipeButtonsPoolEntry *> *> * _entries;
+}
+
+static char MGSwipeButtonsPoolKey;
+
++(instancetype) poolForTableView:(UITableView *) tableView
+{
+    MGSwipeButtonsPool * pool = objc_getAssociatedObject(tableView, &MGSwipeButtonsPoolKey);
+    if (!pool) {
+        pool = [[MGSwipeButtonsPool alloc] init];
+        objc_setAssociatedObject(tableView, &MGSwipeButtonsPoolKey, pool, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    return pool;
+}
+
+-(instancetype) init
+{
+    if (self = [super init]) {
+        _entries = [NSMutableDictionary dictionary];
+        _capacity = 16;
+    }
+    return self;
+}
+
+-(NSString *) keyForIdentifier:(NSString *) identifier direction:(MGSwipeDirection) direction
+{
+    return [NSString stringWithFormat:@"%ld/%@", (long)direction, identifier];
+}
+
+-(MGSwipeButtonsPoolEntry *) checkoutButtonsWithIdentifier:(NSString *) identifier direction:(MGSwipeDirection) direction
+{
+    NSMutableArray * entries = [_entries objectForKey:[self keyForIdentifier:identifier direction:direction]];
+    MGSwipeButtonsPoolEntry * entry = [entries lastObject];
+    if (!entry) {
+        _misses++;
+        return nil;
+    }
+    [entries removeLastObject];
+    _count--;
+    _hits++;
+    return entry;
+}
+
+-(void) returnButtons:(MGSwipeButtonsPoolEntry *) entry identifier:(NSString *) identifier direction:(MGSwipeDirection) direction
+{
+    if (_count >= _capacity) {
+        return; //memory cap reached, let the buttons be released
+    }
+    NSString * key = [self keyForIdentifier:identifier direction:direction];
+    NSMutableArray * entries = [_entries objectForKey:key];
+    if (!entries) {
+        entries = [NSMutableArray array];
+        [_entries setObject:entries forKey:key];
+    }
+    [entries addObject:entry];
+    _count++;
+}
+
+-(void) setCapacity:(NSUInteger) capacity
+{
+    _capacity = capacity;
+    if (_count > capacity) {
+        [self removeAllButtons];
+    }
+}
+
+-(void) removeAllButtons
+{
+    [_entries removeAllObjects];
+    _count = 0;
+}
+
+@end
+
+#pragma mark Table Coordinator
+
+@interface MGSwipeTableCell ()
+-(void) cancelPanGesture;
+@end
+
+@interface MGSwipeTableCoordinator ()
+-(instancetype) initWithTableView:(UITableView *) tableView;
+-(void) activateCell:(MGSwipeTableCell *) cell;
+-(void) deactivateCell:(MGSwipeTableCell *) cell;
+-(void) cancelPanGesturesExceptCell:(MGSwipeTableCell *) cell;
+-(void) showInputOverlayForCell:(MGSwipeTableCell *) cell;
+-(void) hideInputOverlayForCell:(MGSwipeTableCell *) cell;
+@end
+
+@implementation MGSwipeTableCoordinator
+{
+    __weak UITableView * _tableView;
+    NSHashTable<MGSwipeTableCell *> * _cells;
+    MGSwipeTableInputOverlay * _inputOverlay;
+}
+
+static char MGSwipeTableCoordinatorKey;
+
++(instancetype) coordinatorForTableView:(UITableView *) tableView
+{
+    MGSwipeTableCoordinator * coordinator = objc_getAssociatedObject(tableView, &MGSwipeTableCoordinatorKey);
+    if (!coordinator) {
+        coordinator = [[MGSwipeTableCoordinator alloc] initWithTableView:tableView];
+        objc_setAssociatedObject(tableView, &MGSwipeTableCoordinatorKey, coordinator, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+    return coordinator;
+}
+
+-(instancetype) initWithTableView:(UITableView *) tableView
+{
+    if (self = [super init]) {
+        _tableView = tableView;
+        _cells = [NSHashTable weakObjectsHashTable];
+    }
+    return self;
+}
+
+-(NSArray<MGSwipeTableCell *> *) activeCells
+{
+    return [_cells allObjects];
+}
+
+-(void) activateCell:(MGSwipeTableCell *) cell
+{
+    [_cells addObject:cell];
+}
+
+-(void) deactivateCell:(MGSwipeTableCell *) cell
+{
+    [_cells removeObject:cell];
+}
+
+-(void) cancelPanGesturesExceptCell:(MGSwipeTableCell *) cell
+{
+    for (MGSwipeTableCell * active in [_cells allObjects]) {
+        if (active != cell) {
+            [active cancelPanGesture];
+        }
+    }
+}
+
+-(void) showInputOverlayForCell:(MGSwipeTableCell *) cell
+{
+    UITableView * table = _tableView;
+    if (!table) {
+        return;
+    }
+    if (!_inputOverlay) {
+        _inputOverlay = [[MGSwipeTableInputOverlay alloc] initWithFrame:table.bounds];
+    }
+    _inputOverlay.frame = table.bounds;
+    _inputOverlay.currentCell = cell;
+    [table addSubview:_inputOverlay]; //also brings it to front if it was already added
+}
+
+-(void) hideInputOverlayForCell:(MGSwipeTableCell *) cell
+{
+    if (_inputOverlay.currentCell == cell) {
+        _inputOverlay.currentCell = nil;
+        [_inputOverlay removeFromSuperview];
+    }
+}
+
+-(void) hideAllSwipedCellsAnimated:(BOOL) animated
+{
+    [self hideAllSwipedCellsAnimated:animated completion:nil];
+}
+
+-(void) hideAllSwipedCellsAnimated:(BOOL) animated completion:(void(^)(BOOL finished)) completion
+{
+    //all the cells are advanced together by the shared animation scheduler
+    NSArray * cells = [_cells allObjects];
+    __block NSUInteger pending = cells.count;
+    __block BOOL allFinished = YES;
+    if (pending == 0) {
+        if (completion) {
+            completion(YES);
+        }
+        return;
+    }
+    for (MGSwipeTableCell * cell in cells) {
+        [cell hideSwipeAnimated:animated completion:^(BOOL finished) {
+            allFinished = allFinished && finished;
+            if (--pending == 0 && completion) {
+                completion(allFinished);
+            }
+        }];
     }
-    return (*easingFunction)(t, from, to - from);
 }
 
 @end
 
 #pragma mark MGSwipeTableCell Implementation
 
+/** Patches redrawn over the swipe snapshot before they are merged into one */
+static const NSUInteger MGSwipeMaxSnapshotPatches = 8;
+
+/** Bytes of a bitmap of the given size rendered by UIGraphicsImageRenderer, 8 per pixel in the extended range (wide color) format */
+static NSUInteger mgRendererBitmapBytes(CGSize size)
+{
+    UIGraphicsImageRendererFormat * format = [UIGraphicsImageRendererFormat defaultFormat];
+    BOOL extended;
+    if (@available(iOS 12, *)) {
+        extended = format.preferredRange == UIGraphicsImageRendererFormatRangeExtended ||
+            (format.preferredRange == UIGraphicsImageRendererFormatRangeAutomatic && [UIScreen mainScreen].traitCollection.displayGamut == UIDisplayGamutP3);
+    }
+    else {
+        extended = format.prefersExtendedRange;
+    }
+    return (NSUInteger) (ceil(size.width * format.scale) * ceil(size.height * format.scale) * (extended ? 8 : 4));
+}
+
+
+@interface MGSwipeTableCell () <MGSwipeAnimationClient>
+@end
 
 @implementation MGSwipeTableCell
 {
     UITapGestureRecognizer * _tapRecognizer;
     UIPanGestureRecognizer * _panRecognizer;
-    CGPoint _panStartPoint;
-    CGFloat _panStartOffset;
-    CGFloat _targetOffset;
+    MGSwipeMachine _machine;
     
     UIView * _swipeOverlay;
     UIImageView * _swipeView;
+    UIView * _swipeSnapshotView;
     UIView * _swipeContentView;
     MGSwipeButtonsView * _leftView;
     MGSwipeButtonsView * _rightView;
@@ -618,17 +1771,44 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     bool _allowSwipeLeftToRight;
     __weak MGSwipeButtonsView * _activeExpansion;
 
-    MGSwipeTableInputOverlay * _tableInputOverlay;
+    __weak UITableView * _parentTable;
     bool _overlayEnabled;
     UITableViewCellSelectionStyle _previusSelectionStyle;
     NSMutableSet * _previusHiddenViews;
     UITableViewCellAccessoryType _previusAccessoryType;
+    UIEdgeInsets _swipeSafeInsets; //applied to the buttons views
+    UIEdgeInsets _swipeContentInsets; //contentView insets in the cell when the swipe started, the accessory area outside is never redrawn
+    NSMutableArray<UIImageView *> * _snapshotPatches; //rects redrawn over the snapshot by refreshContentViewInRect:
+    BOOL _snapshotRefreshPending;
     BOOL _triggerStateChanges;
     
+    __weak MGSwipeButtonsPool * _buttonsPool;
+    NSArray<MGSwipeButtonDescriptor *> * _leftDescriptors;
+    NSArray<MGSwipeButtonDescriptor *> * _rightDescriptors;
+    NSString * _leftButtonsIdentifier;
+    NSString * _rightButtonsIdentifier;
+    MGSwipeButtonsView * _pooledLeftView;
+    MGSwipeButtonsView * _pooledRightView;
+    //settings configured by the delegate for the poolable buttons, indexed by MGSwipeDirection. nil when the buttons were
+    //built with settings customized on the cell, they aren't returned to the pool
+    MGSwipeSettings * _poolSettings[2];
+    MGSwipeExpansionSettings * _poolExpansions[2];
+    MGSwipeSettings * _spareSettings[2]; //uncustomized copies handed to the delegate, indexed by MGSwipeDirection
+    MGSwipeExpansionSettings * _spareExpansions[2];
+
     MGSwipeAnimationData * _animationData;
     void (^_animationCompletion)(BOOL finished);
-    CADisplayLink * _displayLink;
-    MGSwipeState _firstSwipeState;
+    MGSwipeAnimationScheduler * _animationScheduler; //nil uses the shared scheduler
+    BOOL _animating;
+    MGSwipeDelegateCapability _delegateCapabilities;
+    MGSwipeEventQueue * _eventQueue;
+    BOOL _springing;
+    MGSpring _spring;
+    CFTimeInterval _springTimestamp;
+    MGSwipeFrameRateRange _frameRateRange;
+    BOOL _adaptsFrameRate;
+    CGFloat _minimumOffsetDelta;
+    CGFloat _pacedOffset; //last animated offset applied, before the bounce, compared with the next one by minimumOffsetDelta
 }
 
 #pragma mark View creation & layout
@@ -665,46 +1845,102 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
 
 -(void) initViews: (BOOL) cleanButtons
 {
+    MGSettingsAllocationsSample allocationsStart = mgMetricsSettingsAllocations();
     if (cleanButtons) {
         _leftButtons = [NSArray array];
         _rightButtons = [NSArray array];
-        _leftSwipeSettings = [[MGSwipeSettings alloc] init];
-        _rightSwipeSettings = [[MGSwipeSettings alloc] init];
-        _leftExpansion = [[MGSwipeExpansionSettings alloc] init];
-        _rightExpansion = [[MGSwipeExpansionSettings alloc] init];
-    }
-    _animationData = [[MGSwipeAnimationData alloc] init];
-    _panRecognizer = [[UIPanGestureRecognizer alloc] initWithTarget:self action:@selector(panHandler:)];
-    [self addGestureRecognizer:_panRecognizer];
-    _panRecognizer.delegate = self;
+        _leftDescriptors = _rightDescriptors = nil;
+        //shared until customized, see the settings getters
+        _leftSwipeSettings = [MGSwipeSettings sharedDefaultSettings];
+        _rightSwipeSettings = [MGSwipeSettings sharedDefaultSettings];
+        _leftExpansion = [MGSwipeExpansionSettings sharedDefaultSettings];
+        _rightExpansion = [MGSwipeExpansionSettings sharedDefaultSettings];
+    }
+    if (!_panRecognizer) { //kept across reuse
+        _panRecognizer = [[UIPanGestureRecognizer alloc] initWithTarget:self action:@selector(panHandler:)];
+        [self addGestureRecognizer:_panRecognizer];
+        _panRecognizer.delegate = self;
+    }
     _activeExpansion = nil;
-    _previusHiddenViews = [NSMutableSet set];
     _swipeState = MGSwipeStateNone;
     _triggerStateChanges = YES;
     _allowsSwipeWhenTappingButtons = YES;
     _preservesSelectionStatus = NO;
     _allowsOppositeSwipe = YES;
-    _firstSwipeState = MGSwipeStateNone;
-    
+    MGSwipeConfig config = [self swipeMachineConfig];
+    mgSwipeMachineInit(&_machine, &config);
+    mgMetricsRecordSettingsAllocations(allocationsStart);
+}
+
+-(void) cleanViews
+{
+    [self hideSwipeAnimated:NO];
+    if (_animating) {
+        [self.animationScheduler removeClient:self];
+        _animating = NO;
+    }
+    if (_swipeOverlay) {
+        [_swipeOverlay removeFromSuperview];
+        _swipeOverlay = nil;
+    }
+    [self returnButtonsToPool];
+    _leftView = _rightView = nil;
+    _snapshotRefreshPending = NO; //the overlay is gone, a queued refresh has nothing to draw
+    if (_panRecognizer.state != UIGestureRecognizerStatePossible) { //cancel the gesture, the recognizer is reused
+        _panRecognizer.enabled = NO;
+        _panRecognizer.enabled = YES;
+    }
+}
+
+#pragma mark Settings
+
+// The settings getters copy on write: cells share the default settings until they are accessed for customization.
+// The delegate customizes a spare default copy instead, which the cell only adopts if the delegate changes it
+
+-(MGSwipeSettings *) spareSettings:(MGSwipeDirection) direction
+{
+    MGSwipeSettings * settings = _spareSettings[direction] ?: [[MGSwipeSettings alloc] init];
+    _spareSettings[direction] = nil;
+    return settings;
+}
+
+-(MGSwipeExpansionSettings *) spareExpansion:(MGSwipeDirection) direction
+{
+    MGSwipeExpansionSettings * expansion = _spareExpansions[direction] ?: [[MGSwipeExpansionSettings alloc] init];
+    _spareExpansions[direction] = nil;
+    return expansion;
+}
+
+-(MGSwipeSettings *) leftSwipeSettings
+{
+    if (_leftSwipeSettings == [MGSwipeSettings sharedDefaultSettings]) {
+        _leftSwipeSettings = [self spareSettings:MGSwipeDirectionLeftToRight];
+    }
+    return _leftSwipeSettings;
 }
 
--(void) cleanViews
+-(MGSwipeSettings *) rightSwipeSettings
 {
-    [self hideSwipeAnimated:NO];
-    if (_displayLink) {
-        [_displayLink invalidate];
-        _displayLink = nil;
+    if (_rightSwipeSettings == [MGSwipeSettings sharedDefaultSettings]) {
+        _rightSwipeSettings = [self spareSettings:MGSwipeDirectionRightToLeft];
     }
-    if (_swipeOverlay) {
-        [_swipeOverlay removeFromSuperview];
-        _swipeOverlay = nil;
+    return _rightSwipeSettings;
+}
+
+-(MGSwipeExpansionSettings *) leftExpansion
+{
+    if (_leftExpansion == [MGSwipeExpansionSettings sharedDefaultSettings]) {
+        _leftExpansion = [self spareExpansion:MGSwipeDirectionLeftToRight];
     }
-    _leftView = _rightView = nil;
-    if (_panRecognizer) {
-        _panRecognizer.delegate = nil;
-        [self removeGestureRecognizer:_panRecognizer];
-        _panRecognizer = nil;
+    return _leftExpansion;
+}
+
+-(MGSwipeExpansionSettings *) rightExpansion
+{
+    if (_rightExpansion == [MGSwipeExpansionSettings sharedDefaultSettings]) {
+        _rightExpansion = [self spareExpansion:MGSwipeDirectionRightToLeft];
     }
+    return _rightExpansion;
 }
 
 - (BOOL)isAppExtension
@@ -773,40 +2009,257 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
         CGSize prevSize = _swipeView.bounds.size;
         _swipeOverlay.frame = CGRectMake(0, 0, self.bounds.size.width, self.contentView.bounds.size.height);
         [self fixRegionAndAccesoryViews];
-        if (_swipeView.image &&  !CGSizeEqualToSize(prevSize, _swipeOverlay.bounds.size)) {
-            //refresh safeInsets in situations like layout change, orientation change, table resize, etc.
-            UIEdgeInsets safeInsets = [self getSafeInsets];
-            // Refresh safe insets
-            if (_leftView) {
-                CGFloat width = _leftView.bounds.size.width;
-                [_leftView setSafeInset:safeInsets.left extendEdgeButton:_leftSwipeSettings.expandLastButtonBySafeAreaInsets isRTL: [self isRTLLocale]];
-                if (_swipeOffset > 0 && _leftView.bounds.size.width != width) {
-                    // Adapt offset to the view change size due to safeInsets
-                    _swipeOffset += _leftView.bounds.size.width - width;
-                }
+        if (!_swipeView.image && !_swipeSnapshotView) {
+            return;
+        }
+        BOOL resized = !CGSizeEqualToSize(prevSize, _swipeOverlay.bounds.size);
+        //refresh safeInsets in situations like layout change, orientation change, table resize, etc.
+        UIEdgeInsets safeInsets = [self getSafeInsets];
+        if (!resized && UIEdgeInsetsEqualToEdgeInsets(safeInsets, _swipeSafeInsets)) {
+            return;
+        }
+        _swipeSafeInsets = safeInsets;
+        if (_leftView) {
+            CGFloat width = _leftView.bounds.size.width;
+            [_leftView setSafeInset:safeInsets.left extendEdgeButton:_leftSwipeSettings.expandLastButtonBySafeAreaInsets isRTL: [self isRTLLocale]];
+            if (_swipeOffset > 0 && _leftView.bounds.size.width != width) {
+                // Adapt offset to the view change size due to safeInsets
+                _swipeOffset += _leftView.bounds.size.width - width;
             }
-            if (_rightView) {
-                CGFloat width = _rightView.bounds.size.width;
-                [_rightView setSafeInset:safeInsets.right extendEdgeButton:_rightSwipeSettings.expandLastButtonBySafeAreaInsets isRTL: [self isRTLLocale]];
-                if (_swipeOffset < 0 && _rightView.bounds.size.width != width) {
-                    // Adapt offset to the view change size due to safeInsets
-                    _swipeOffset -= _rightView.bounds.size.width - width;
-                }
+        }
+        if (_rightView) {
+            CGFloat width = _rightView.bounds.size.width;
+            [_rightView setSafeInset:safeInsets.right extendEdgeButton:_rightSwipeSettings.expandLastButtonBySafeAreaInsets isRTL: [self isRTLLocale]];
+            if (_swipeOffset < 0 && _rightView.bounds.size.width != width) {
+                // Adapt offset to the view change size due to safeInsets
+                _swipeOffset -= _rightView.bounds.size.width - width;
             }
-            //refresh contentView in situations like layout change, orientation chage, table resize, etc.
-            [self refreshContentView];
+        }
+        //lay out the buttons again, keeping the overlay and the gesture state. A safe area change alone keeps the snapshot
+        [self relayoutSwipeButtons];
+        if (resized) {
+            [self setNeedsSnapshotRefresh];
         }
     }
 }
 
+-(BOOL) delegateProvidesButtons
+{
+    return [self delegateResponds:MGSwipeDelegateCapabilitySwipeButtons | MGSwipeDelegateCapabilitySwipeButtonDescriptors];
+}
+
 -(void) fetchButtonsIfNeeded
 {
-    if (_leftButtons.count == 0 && _delegate && [_delegate respondsToSelector:@selector(swipeTableCell:swipeButtonsForDirection:swipeSettings:expansionSettings:)]) {
-        _leftButtons = [_delegate swipeTableCell:self swipeButtonsForDirection:MGSwipeDirectionLeftToRight swipeSettings:_leftSwipeSettings expansionSettings:_leftExpansion];
+    if (![self delegateProvidesButtons]) {
+        return;
+    }
+    CFTimeInterval metricsStart = mgMetricsStart();
+    MGSettingsAllocationsSample allocationsStart = mgMetricsSettingsAllocations();
+    BOOL fetched = NO;
+    //descriptors are only fetched here, they are turned into buttons when the swipe views are created
+    BOOL descriptors = [self delegateResponds:MGSwipeDelegateCapabilitySwipeButtonDescriptors];
+    if (_leftButtons.count == 0 && _leftDescriptors.count == 0 && ![self checkoutPooledButtons:MGSwipeDirectionLeftToRight]) {
+        MGSwipeSettings * settings = [self settingsForFetch:MGSwipeDirectionLeftToRight];
+        MGSwipeExpansionSettings * expansion = [self expansionForFetch:MGSwipeDirectionLeftToRight];
+        if (descriptors) {
+            _leftDescriptors = [_delegate swipeTableCell:self swipeButtonDescriptorsForDirection:MGSwipeDirectionLeftToRight swipeSettings:settings expansionSettings:expansion];
+        }
+        else {
+            _leftButtons = [_delegate swipeTableCell:self swipeButtonsForDirection:MGSwipeDirectionLeftToRight swipeSettings:settings expansionSettings:expansion];
+        }
+        [self adoptFetchedSettings:settings expansion:expansion direction:MGSwipeDirectionLeftToRight];
+        fetched = YES;
+    }
+    if (_rightButtons.count == 0 && _rightDescriptors.count == 0 && ![self checkoutPooledButtons:MGSwipeDirectionRightToLeft]) {
+        MGSwipeSettings * settings = [self settingsForFetch:MGSwipeDirectionRightToLeft];
+        MGSwipeExpansionSettings * expansion = [self expansionForFetch:MGSwipeDirectionRightToLeft];
+        if (descriptors) {
+            _rightDescriptors = [_delegate swipeTableCell:self swipeButtonDescriptorsForDirection:MGSwipeDirectionRightToLeft swipeSettings:settings expansionSettings:expansion];
+        }
+        else {
+            _rightButtons = [_delegate swipeTableCell:self swipeButtonsForDirection:MGSwipeDirectionRightToLeft swipeSettings:settings expansionSettings:expansion];
+        }
+        [self adoptFetchedSettings:settings expansion:expansion direction:MGSwipeDirectionRightToLeft];
+        fetched = YES;
+    }
+    if (fetched) {
+        mgMetricsRecordDuration(MGSwipeMetricButtonsFetchDuration, metricsStart);
+        mgMetricsRecordSettingsAllocations(allocationsStart);
+    }
+}
+
+/** The cell's own settings, or a spare default copy while the cell shares the defaults */
+-(MGSwipeSettings *) settingsForFetch:(MGSwipeDirection) direction
+{
+    MGSwipeSettings * settings = direction == MGSwipeDirectionLeftToRight ? _leftSwipeSettings : _rightSwipeSettings;
+    if (settings != [MGSwipeSettings sharedDefaultSettings]) {
+        return settings;
+    }
+    if (!_spareSettings[direction]) {
+        _spareSettings[direction] = [[MGSwipeSettings alloc] init];
+    }
+    return _spareSettings[direction];
+}
+
+-(MGSwipeExpansionSettings *) expansionForFetch:(MGSwipeDirection) direction
+{
+    MGSwipeExpansionSettings * expansion = direction == MGSwipeDirectionLeftToRight ? _leftExpansion : _rightExpansion;
+    if (expansion != [MGSwipeExpansionSettings sharedDefaultSettings]) {
+        return expansion;
+    }
+    if (!_spareExpansions[direction]) {
+        _spareExpansions[direction] = [[MGSwipeExpansionSettings alloc] init];
+    }
+    return _spareExpansions[direction];
+}
+
+-(void) adoptFetchedSettings:(MGSwipeSettings *) settings expansion:(MGSwipeExpansionSettings *) expansion direction:(MGSwipeDirection) direction
+{
+    BOOL left = direction == MGSwipeDirectionLeftToRight;
+    NSString * identifier = left ? _leftButtonsIdentifier : _rightButtonsIdentifier;
+    BOOL delegateOnly = identifier && settings == _spareSettings[direction] && expansion == _spareExpansions[direction];
+    [self adoptCustomizedSpares:direction];
+    //only buttons configured by the delegate alone are pooled, with a copy of the settings the cell can't change afterwards
+    [self setPoolSettings:delegateOnly ? (left ? _leftSwipeSettings : _rightSwipeSettings) : nil
+                expansion:delegateOnly ? (left ? _leftExpansion : _rightExpansion) : nil
+                direction:direction copy:YES];
+}
+
+/**
+ * Spare copies customized by the delegate become the cell's settings, the others stay spare for the next fetch.
+ * Checked after the fetch and again when the swipe views are created, the delegate may keep the copy and customize it later
+ */
+-(void) adoptCustomizedSpares:(MGSwipeDirection) direction
+{
+    BOOL left = direction == MGSwipeDirectionLeftToRight;
+    BOOL adopted = NO;
+    MGSwipeSettings * settings = _spareSettings[direction];
+    if (settings.customized && (left ? _leftSwipeSettings : _rightSwipeSettings) == [MGSwipeSettings sharedDefaultSettings]) {
+        _spareSettings[direction] = nil;
+        if (left) {
+            _leftSwipeSettings = settings;
+        }
+        else {
+            _rightSwipeSettings = settings;
+        }
+        adopted = YES;
+    }
+    MGSwipeExpansionSettings * expansion = _spareExpansions[direction];
+    if (expansion.customized && (left ? _leftExpansion : _rightExpansion) == [MGSwipeExpansionSettings sharedDefaultSettings]) {
+        _spareExpansions[direction] = nil;
+        if (left) {
+            _leftExpansion = expansion;
+        }
+        else {
+            _rightExpansion = expansion;
+        }
+        adopted = YES;
+    }
+    if (adopted && _poolSettings[direction]) {
+        //still configured by the delegate alone, pool the buttons with its latest settings
+        [self setPoolSettings:left ? _leftSwipeSettings : _rightSwipeSettings expansion:left ? _leftExpansion : _rightExpansion
+                    direction:direction copy:YES];
+    }
+}
+
+-(void) setPoolSettings:(MGSwipeSettings *) settings expansion:(MGSwipeExpansionSettings *) expansion direction:(MGSwipeDirection) direction copy:(BOOL) copy
+{
+    if (copy && settings != [MGSwipeSettings sharedDefaultSettings]) {
+        settings = [settings copy];
+    }
+    if (copy && expansion != [MGSwipeExpansionSettings sharedDefaultSettings]) {
+        expansion = [expansion copy];
+    }
+    _poolSettings[direction] = settings;
+    _poolExpansions[direction] = expansion;
+}
+
+-(NSArray *) buttonsFromDescriptors:(NSArray<MGSwipeButtonDescriptor *> *) descriptors settings:(MGSwipeSettings *) settings
+{
+    NSMutableArray * buttons = [NSMutableArray arrayWithCapacity:descriptors.count];
+    for (MGSwipeButtonDescriptor * descriptor in descriptors) {
+        [buttons addObject:settings.prerendersDescriptorButtons ? [descriptor renderedButton] : [descriptor button]];
+    }
+    return buttons;
+}
+
+-(BOOL) checkoutPooledButtons:(MGSwipeDirection) direction
+{
+    if (![self delegateResponds:MGSwipeDelegateCapabilityButtonsIdentifier]) {
+        return NO;
+    }
+    NSString * identifier = [_delegate swipeTableCell:self buttonsIdentifierForDirection:direction];
+    UITableView * table = identifier ? [self parentTable] : nil;
+    if (!table) {
+        return NO;
+    }
+    MGSwipeButtonsPool * pool = [MGSwipeButtonsPool poolForTableView:table];
+    _buttonsPool = pool;
+    MGSwipeButtonsPoolEntry * entry = [pool checkoutButtonsWithIdentifier:identifier direction:direction];
+    //settings configured on the cell before the swipe (e.g. in cellForRowAtIndexPath) are kept, the pooled buttons
+    //are laid out again with them and aren't returned to the pool. The pooled settings, configured by the delegate
+    //with the buttons, are only adopted by cells that still use the defaults. They get a copy, the entry's are
+    //returned unchanged with the buttons
+    BOOL left = direction == MGSwipeDirectionLeftToRight;
+    if (left) {
+        _leftButtonsIdentifier = identifier;
+    }
+    else {
+        _rightButtonsIdentifier = identifier;
+    }
+    if (!entry) {
+        return NO;
+    }
+    BOOL defaultSettings = (left ? _leftSwipeSettings : _rightSwipeSettings) == [MGSwipeSettings sharedDefaultSettings];
+    BOOL defaultExpansion = (left ? _leftExpansion : _rightExpansion) == [MGSwipeExpansionSettings sharedDefaultSettings];
+    BOOL adopt = defaultSettings && defaultExpansion;
+    [self setPoolSettings:adopt ? entry.settings : nil expansion:adopt ? entry.expansion : nil direction:direction copy:NO];
+    if (left) {
+        _leftButtons = entry.buttons;
+        _pooledLeftView = adopt ? entry.buttonsView : nil;
+    }
+    else {
+        _rightButtons = entry.buttons;
+        _pooledRightView = adopt ? entry.buttonsView : nil;
+    }
+    if (adopt) {
+        MGSwipeSettings * settings = entry.settings == [MGSwipeSettings sharedDefaultSettings] ? entry.settings : [entry.settings copy];
+        MGSwipeExpansionSettings * expansion = entry.expansion == [MGSwipeExpansionSettings sharedDefaultSettings] ? entry.expansion : [entry.expansion copy];
+        if (left) {
+            _leftSwipeSettings = settings;
+            _leftExpansion = expansion;
+        }
+        else {
+            _rightSwipeSettings = settings;
+            _rightExpansion = expansion;
+        }
     }
-    if (_rightButtons.count == 0 && _delegate && [_delegate respondsToSelector:@selector(swipeTableCell:swipeButtonsForDirection:swipeSettings:expansionSettings:)]) {
-        _rightButtons = [_delegate swipeTableCell:self swipeButtonsForDirection:MGSwipeDirectionRightToLeft swipeSettings:_rightSwipeSettings expansionSettings:_rightExpansion];
+    return YES;
+}
+
+-(void) returnButtonsToPool
+{
+    MGSwipeButtonsPool * pool = _buttonsPool;
+    MGSwipeButtonsView * views[2] = {_leftView ?: _pooledLeftView, _rightView ?: _pooledRightView};
+    NSString * identifiers[2] = {_leftButtonsIdentifier, _rightButtonsIdentifier};
+    for (int i = 0; i < 2; ++i) {
+        MGSwipeButtonsView * view = views[i];
+        if (!pool || !view || !identifiers[i] || !_poolSettings[i]) continue;
+        [view endExpansionAnimated:NO];
+        [view removeFromSuperview];
+        view.transform = CGAffineTransformIdentity;
+        view.cell = nil;
+        MGSwipeButtonsPoolEntry * entry = [[MGSwipeButtonsPoolEntry alloc] init];
+        entry.buttonsView = view;
+        entry.buttons = i ? _rightButtons : _leftButtons;
+        entry.settings = _poolSettings[i];
+        entry.expansion = _poolExpansions[i];
+        [pool returnButtons:entry identifier:identifiers[i] direction:i ? MGSwipeDirectionRightToLeft : MGSwipeDirectionLeftToRight];
     }
+    _leftButtonsIdentifier = _rightButtonsIdentifier = nil;
+    _pooledLeftView = _pooledRightView = nil;
+    _poolSettings[0] = _poolSettings[1] = nil;
+    _poolExpansions[0] = _poolExpansions[1] = nil;
 }
 
 -(void) createSwipeViewIfNeeded
@@ -820,16 +2273,27 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
         _swipeOverlay.layer.zPosition = 10; //force render on top of the contentView;
         _swipeView = [[UIImageView alloc] initWithFrame:_swipeOverlay.bounds];
         _swipeView.autoresizingMask =  UIViewAutoresizingFlexibleWidth | UIViewAutoresizingFlexibleHeight;
-        _swipeView.contentMode = UIViewContentModeCenter;
+        _swipeView.contentMode = [self isRTLLocale] ? UIViewContentModeTopLeft : UIViewContentModeTopRight; //the accessory stays on its edge after a resize
         _swipeView.clipsToBounds = YES;
         [_swipeOverlay addSubview:_swipeView];
         [self.contentView addSubview:_swipeOverlay];
     }
     
     [self fetchButtonsIfNeeded];
+    [self adoptCustomizedSpares:MGSwipeDirectionLeftToRight];
+    [self adoptCustomizedSpares:MGSwipeDirectionRightToLeft];
+    if (_leftButtons.count == 0 && _leftDescriptors.count > 0) {
+        _leftButtons = [self buttonsFromDescriptors:_leftDescriptors settings:_leftSwipeSettings];
+    }
+    if (_rightButtons.count == 0 && _rightDescriptors.count > 0) {
+        _rightButtons = [self buttonsFromDescriptors:_rightDescriptors settings:_rightSwipeSettings];
+    }
     if (!_leftView && _leftButtons.count > 0) {
-        _leftSwipeSettings.allowsButtonsWithDifferentWidth = _leftSwipeSettings.allowsButtonsWithDifferentWidth || _allowsButtonsWithDifferentWidth;
-        _leftView = [[MGSwipeButtonsView alloc] initWithButtons:_leftButtons direction:MGSwipeDirectionLeftToRight swipeSettings:_leftSwipeSettings safeInset:safeInsets.left];
+        if (_allowsButtonsWithDifferentWidth) {
+            self.leftSwipeSettings.allowsButtonsWithDifferentWidth = YES;
+        }
+        _leftView = _pooledLeftView ?: [[MGSwipeButtonsView alloc] initWithButtons:_leftButtons direction:MGSwipeDirectionLeftToRight swipeSettings:_leftSwipeSettings safeInset:safeInsets.left];
+        _pooledLeftView = nil;
         _leftView.cell = self;
         _leftView.frame = CGRectMake(-_leftView.bounds.size.width + safeInsets.left * ([self isRTLLocale] ? 1 : -1),
                                      _leftSwipeSettings.topMargin,
@@ -839,8 +2303,11 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
         [_swipeOverlay addSubview:_leftView];
     }
     if (!_rightView && _rightButtons.count > 0) {
-        _rightSwipeSettings.allowsButtonsWithDifferentWidth = _rightSwipeSettings.allowsButtonsWithDifferentWidth || _allowsButtonsWithDifferentWidth;
-        _rightView = [[MGSwipeButtonsView alloc] initWithButtons:_rightButtons direction:MGSwipeDirectionRightToLeft swipeSettings:_rightSwipeSettings safeInset:safeInsets.right];
+        if (_allowsButtonsWithDifferentWidth) {
+            self.rightSwipeSettings.allowsButtonsWithDifferentWidth = YES;
+        }
+        _rightView = _pooledRightView ?: [[MGSwipeButtonsView alloc] initWithButtons:_rightButtons direction:MGSwipeDirectionRightToLeft swipeSettings:_rightSwipeSettings safeInset:safeInsets.right];
+        _pooledRightView = nil;
         _rightView.cell = self;
         _rightView.frame = CGRectMake(_swipeOverlay.bounds.size.width + safeInsets.right * ([self isRTLLocale] ? 1 : -1),
                                       _rightSwipeSettings.topMargin,
@@ -858,6 +2325,7 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     if (_rightView) {
         [_rightView setSafeInset:safeInsets.right extendEdgeButton:_rightSwipeSettings.expandLastButtonBySafeAreaInsets isRTL: [self isRTLLocale]];
     }
+    _swipeSafeInsets = safeInsets;
 }
 
 
@@ -868,31 +2336,49 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     }
     _overlayEnabled = YES;
     
+    BOOL deselected = !_preservesSelectionStatus && self.selected;
     if (!_preservesSelectionStatus)
         self.selected = NO;
     if (_swipeContentView)
         [_swipeContentView removeFromSuperview];
-    if (_delegate && [_delegate respondsToSelector:@selector(swipeTableCellWillBeginSwiping:)]) {
+    if ([self delegateResponds:MGSwipeDelegateCapabilityWillBeginSwiping]) {
         [_delegate swipeTableCellWillBeginSwiping:self];
     }
     
     // snapshot cell without separator
     CGSize  cropSize        = CGSizeMake(self.bounds.size.width, self.contentView.bounds.size.height);
-    _swipeView.image = [self imageFromView:self cropSize:cropSize];
+    CGRect  contentFrame    = self.contentView.frame;
+    _swipeContentInsets = UIEdgeInsetsMake(0, CGRectGetMinX(contentFrame), 0, self.bounds.size.width - CGRectGetMaxX(contentFrame));
+    CFTimeInterval metricsStart = mgMetricsStart();
+    if (_snapshotMode == MGSwipeSnapshotModeView) {
+        // GPU backed snapshot, clipped by _swipeView to the contentView height.
+        // Like the bitmap it must not contain the selection nor the swipeContentView removed above. Only then the screen is
+        // updated first, which commits and renders synchronously. Otherwise the snapshot reuses what's already on screen
+        BOOL screenOutdated = deselected || _swipeContentView;
+        _swipeSnapshotView = [self snapshotViewAfterScreenUpdates:screenOutdated];
+        _swipeSnapshotView.frame = CGRectMake(0, 0, self.bounds.size.width, self.bounds.size.height);
+        _swipeSnapshotView.autoresizingMask = [self isRTLLocale] ? UIViewAutoresizingFlexibleRightMargin : UIViewAutoresizingFlexibleLeftMargin;
+        [_swipeView addSubview:_swipeSnapshotView];
+        _snapshotBytes = mgRendererBitmapBytes(cropSize);
+    }
+    else {
+        _swipeView.image = [self imageFromView:self cropSize:cropSize];
+        CGImageRef image = _swipeView.image.CGImage;
+        _snapshotBytes = CGImageGetBytesPerRow(image) * CGImageGetHeight(image);
+    }
+    mgMetricsRecordDuration(MGSwipeMetricSnapshotDuration, metricsStart);
+    mgMetricsRecord(MGSwipeMetricSnapshotBytes, _snapshotMode == MGSwipeSnapshotModeView ? 0 : _snapshotBytes);
     
     _swipeOverlay.hidden = NO;
     if (_swipeContentView)
         [_swipeView addSubview:_swipeContentView];
     
+    UITableView * table = [self parentTable];
+    MGSwipeTableCoordinator * coordinator = table ? [MGSwipeTableCoordinator coordinatorForTableView:table] : nil;
+    [coordinator activateCell:self];
     if (!_allowsMultipleSwipe) {
-        //input overlay on the whole table
-        UITableView * table = [self parentTable];
-        if (_tableInputOverlay) {
-            [_tableInputOverlay removeFromSuperview];
-        }
-        _tableInputOverlay = [[MGSwipeTableInputOverlay alloc] initWithFrame:table.bounds];
-        _tableInputOverlay.currentCell = self;
-        [table addSubview:_tableInputOverlay];
+        //input overlay on the whole table, shared by all the cells of the table
+        [coordinator showInputOverlayForCell:self];
     }
 
     _previusSelectionStyle = self.selectionStyle;
@@ -913,14 +2399,21 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     _overlayEnabled = NO;
     _swipeOverlay.hidden = YES;
     _swipeView.image = nil;
+    if (_swipeSnapshotView) {
+        [_swipeSnapshotView removeFromSuperview];
+        _swipeSnapshotView = nil;
+    }
+    [self removeSnapshotPatches];
     if (_swipeContentView) {
         [_swipeContentView removeFromSuperview];
         [self.contentView addSubview:_swipeContentView];
     }
     
-    if (_tableInputOverlay) {
-        [_tableInputOverlay removeFromSuperview];
-        _tableInputOverlay = nil;
+    UITableView * table = [self parentTable];
+    if (table) {
+        MGSwipeTableCoordinator * coordinator = [MGSwipeTableCoordinator coordinatorForTableView:table];
+        [coordinator hideInputOverlayForCell:self];
+        [coordinator deactivateCell:self];
     }
 
     if (reselectCellIfNeeded) {
@@ -933,7 +2426,7 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     }
     [self setAccesoryViewsHidden:NO];
     
-    if (_delegate && [_delegate respondsToSelector:@selector(swipeTableCellWillEndSwiping:)]) {
+    if ([self delegateResponds:MGSwipeDelegateCapabilityWillEndSwiping]) {
         [_delegate swipeTableCellWillEndSwiping:self];
     }
     
@@ -953,11 +2446,92 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     _triggerStateChanges = prevValue;
 }
 
+-(void) refreshContentViewInRect:(CGRect) rect
+{
+    if (!_overlayEnabled) {
+        return; //not swiped, the contentView is visible and draws itself
+    }
+    //the overlay and the accessory are left untouched, only the content area captured when the swipe started is redrawn
+    CGRect contentRect = UIEdgeInsetsInsetRect(CGRectMake(0, 0, self.bounds.size.width, self.contentView.bounds.size.height), _swipeContentInsets);
+    CGRect dirty = CGRectIntersection(CGRectIntegral(rect), contentRect);
+    if (CGRectIsEmpty(dirty)) {
+        return;
+    }
+    CFTimeInterval metricsStart = mgMetricsStart();
+    if (!_snapshotPatches) {
+        _snapshotPatches = [NSMutableArray array];
+    }
+    if (_snapshotPatches.count >= MGSwipeMaxSnapshotPatches) {
+        //merge all the patches into a single one, the bitmaps don't grow with the number of refreshes
+        for (UIImageView * patch in _snapshotPatches) {
+            dirty = CGRectUnion(dirty, patch.frame);
+        }
+        [self removeSnapshotPatches];
+    }
+    else {
+        NSIndexSet * covered = [_snapshotPatches indexesOfObjectsPassingTest:^BOOL(UIImageView * patch, NSUInteger idx, BOOL * stop) {
+            return CGRectContainsRect(dirty, patch.frame);
+        }];
+        [[_snapshotPatches objectsAtIndexes:covered] makeObjectsPerformSelector:@selector(removeFromSuperview)];
+        [_snapshotPatches removeObjectsAtIndexes:covered];
+    }
+    UIImageView * patch = [[UIImageView alloc] initWithFrame:dirty];
+    patch.image = [self imageOfSwipedContentInRect:dirty];
+    if (_swipeContentView.superview == _swipeView) {
+        [_swipeView insertSubview:patch belowSubview:_swipeContentView];
+    }
+    else {
+        [_swipeView addSubview:patch];
+    }
+    [_snapshotPatches addObject:patch];
+    mgMetricsRecordDuration(MGSwipeMetricSnapshotDuration, metricsStart);
+}
+
+-(void) removeSnapshotPatches
+{
+    [_snapshotPatches makeObjectsPerformSelector:@selector(removeFromSuperview)];
+    [_snapshotPatches removeAllObjects];
+}
+
+/**
+ * Redraws the whole content area of the snapshot on the next main queue turn, coalescing the requests,
+ * once the contentView subviews have their new layout
+ */
+-(void) setNeedsSnapshotRefresh
+{
+    if (_snapshotRefreshPending) {
+        return;
+    }
+    _snapshotRefreshPending = YES;
+    __weak MGSwipeTableCell * weakself = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        MGSwipeTableCell * cell = weakself;
+        if (cell && cell->_snapshotRefreshPending) {
+            cell->_snapshotRefreshPending = NO;
+            [cell removeSnapshotPatches];
+            [cell refreshContentViewInRect:cell.bounds];
+        }
+    });
+}
+
+/** Lays out the buttons for the current offset again without state changes, e.g. after a size or safe area change */
+-(void) relayoutSwipeButtons
+{
+    BOOL prevValue = _triggerStateChanges;
+    _triggerStateChanges = NO;
+    self.swipeOffset = _swipeOffset;
+    _triggerStateChanges = prevValue;
+}
+
 -(void) refreshButtons: (BOOL) usingDelegate
 {
     if (usingDelegate) {
         self.leftButtons = @[];
         self.rightButtons = @[];
+        _leftDescriptors = _rightDescriptors = nil;
+        //the buttons are being replaced, don't keep the old ones in the pool
+        _leftButtonsIdentifier = _rightButtonsIdentifier = nil;
+        _pooledLeftView = _pooledRightView = nil;
     }
     if (_leftView) {
         [_leftView removeFromSuperview];
@@ -980,6 +2554,12 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     }
 }
 
+-(void) didMoveToSuperview
+{
+    [super didMoveToSuperview];
+    _parentTable = nil;
+}
+
 -(void) prepareForReuse
 {
     [super prepareForReuse];
@@ -988,7 +2568,9 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
         _triggerStateChanges = YES;
         [self updateState:MGSwipeStateNone];
     }
-    BOOL cleanButtons = _delegate && [_delegate respondsToSelector:@selector(swipeTableCell:swipeButtonsForDirection:swipeSettings:expansionSettings:)];
+    //after the forced state update, nothing queued for the previous row is delivered once reused
+    [_eventQueue discardEvents];
+    BOOL cleanButtons = [self delegateProvidesButtons];
     [self initViews:cleanButtons];
 }
 
@@ -1036,6 +2618,41 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     return image;
 }
 
+/**
+ * Renders the contentView subviews hidden by the swipe that intersect rect (in the cell coordinate space) into a bitmap
+ * the size of rect. Each view is shown only while it renders, no transaction is committed in between so it never reaches the screen
+ */
+-(UIImage *) imageOfSwipedContentInRect:(CGRect) rect
+{
+    [self.contentView layoutIfNeeded];
+    NSMutableArray<UIView *> * views = [NSMutableArray array];
+    for (UIView * view in self.contentView.subviews) { //keeps the z order
+        if ([_previusHiddenViews containsObject:view] && CGRectIntersectsRect([view convertRect:view.bounds toView:self], rect)) {
+            [views addObject:view];
+        }
+    }
+    UIColor * background = [self backgroundColorForSwipe];
+    UIGraphicsImageRenderer * renderer = [[UIGraphicsImageRenderer alloc] initWithSize:rect.size];
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+    UIImage * image = [renderer imageWithActions:^(UIGraphicsImageRendererContext * _Nonnull rendererContext) {
+        CGContextRef context = [rendererContext CGContext];
+        [background setFill];
+        [rendererContext fillRect:CGRectMake(0, 0, rect.size.width, rect.size.height)];
+        for (UIView * view in views) {
+            CGPoint origin = [view convertPoint:CGPointZero toView:self];
+            CGContextSaveGState(context);
+            CGContextTranslateCTM(context, origin.x - rect.origin.x, origin.y - rect.origin.y);
+            view.hidden = NO;
+            [view.layer renderInContext:context];
+            view.hidden = YES;
+            CGContextRestoreGState(context);
+        }
+    }];
+    [CATransaction commit];
+    return image;
+}
+
 -(void) setAccesoryViewsHidden: (BOOL) hidden
 {
     if (@available(iOS 12, *)) {
@@ -1064,6 +2681,9 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
         if (view == _swipeOverlay || view == _swipeContentView) continue;
         if (hidden && !view.hidden) {
             view.hidden = YES;
+            if (!_previusHiddenViews) {
+                _previusHiddenViews = [NSMutableSet set];
+            }
             [_previusHiddenViews addObject:view];
         }
         else if (!hidden && [_previusHiddenViews containsObject:view]) {
@@ -1092,10 +2712,15 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
 
 -(UITableView *) parentTable
 {
+    UITableView * table = _parentTable;
+    if (table) {
+        return table; //cached until the cell moves to another superview
+    }
     UIView * view = self.superview;
     while(view != nil) {
         if([view isKindOfClass:[UITableView class]]) {
-            return (UITableView*) view;
+            _parentTable = (UITableView*) view;
+            return _parentTable;
         }
         view = view.superview;
     }
@@ -1108,51 +2733,142 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
         return;
     }
     _swipeState = newState;
-    if (_delegate && [_delegate respondsToSelector:@selector(swipeTableCell:didChangeSwipeState:gestureIsActive:)]) {
+    if (_coalescesSwipeEvents) {
+        [self enqueueSwipeEvent:MGSwipeEventKindState];
+    }
+    else if ([self delegateResponds:MGSwipeDelegateCapabilityDidChangeSwipeState]) {
         [_delegate swipeTableCell:self didChangeSwipeState:_swipeState gestureIsActive: self.isSwipeGestureActive] ;
     }
 }
 
-#pragma mark Swipe Animation
+#pragma mark Delegate Events
 
-- (void)setSwipeOffset:(CGFloat) newOffset;
+-(void) setDelegate:(id<MGSwipeTableCellDelegate>) delegate
 {
-    CGFloat sign = newOffset > 0 ? 1.0 : -1.0;
-    MGSwipeButtonsView * activeButtons = sign < 0 ? _rightView : _leftView;
-    MGSwipeSettings * activeSettings = sign < 0 ? _rightSwipeSettings : _leftSwipeSettings;
-  
-    if(activeSettings.enableSwipeBounces) {
-        _swipeOffset = newOffset;
+    _delegate = delegate;
+    _delegateCapabilities = mgDelegateCapabilities(delegate);
+}
 
-        CGFloat maxUnbouncedOffset = sign * activeButtons.bounds.size.width;
-        
-        if ((sign > 0 && newOffset > maxUnbouncedOffset) || (sign < 0 && newOffset < maxUnbouncedOffset)) {
-            _swipeOffset = maxUnbouncedOffset + (newOffset - maxUnbouncedOffset) * activeSettings.swipeBounceRate;
+-(BOOL) delegateResponds:(MGSwipeDelegateCapability) capability
+{
+    return (_delegateCapabilities & capability) && _delegate;
+}
+
+-(void) enqueueSwipeEvent:(MGSwipeEventKind) kind
+{
+    if (!_eventQueue) {
+        _eventQueue = [[MGSwipeEventQueue alloc] initWithCell:self];
+    }
+    MGSwipeEventRecord record = {kind, (int) _swipeState, _swipeOffset, self.isSwipeGestureActive};
+    [_eventQueue pushEvent:record];
+}
+
+-(void) deliverSwipeEvents:(const MGSwipeEventRecord *) records count:(NSUInteger) count
+{
+    if ([self delegateResponds:MGSwipeDelegateCapabilityDidReceiveSwipeEvents]) {
+        MGSwipeEvent events[MG_EVENT_RING_CAPACITY];
+        for (NSUInteger i = 0; i < count; ++i) {
+            events[i].type = records[i].kind == MGSwipeEventKindState ? MGSwipeEventTypeStateChange : MGSwipeEventTypeOffsetChange;
+            events[i].state = (MGSwipeState) records[i].state;
+            events[i].offset = records[i].offset;
+            events[i].gestureIsActive = records[i].gestureIsActive;
+        }
+        [_delegate swipeTableCell:self didReceiveSwipeEvents:events count:count];
+    }
+    else if ([self delegateResponds:MGSwipeDelegateCapabilityDidChangeSwipeState]) {
+        for (NSUInteger i = 0; i < count; ++i) {
+            if (records[i].kind == MGSwipeEventKindState) {
+                [_delegate swipeTableCell:self didChangeSwipeState:(MGSwipeState) records[i].state gestureIsActive:records[i].gestureIsActive];
+            }
         }
     }
+}
+
+#pragma mark Swipe Animation
+
+-(MGSwipeAnimationScheduler *) animationScheduler
+{
+    return _animationScheduler ?: [MGSwipeAnimationScheduler sharedScheduler];
+}
+
+-(void) setAnimationScheduler:(MGSwipeAnimationScheduler *) animationScheduler
+{
+    MGSwipeAnimationScheduler * previous = self.animationScheduler;
+    _animationScheduler = animationScheduler;
+    if (_animating && previous != self.animationScheduler) {
+        //the running animation continues from the current offset on the clock of the new scheduler
+        _animationData.from = _swipeOffset;
+        _animationData.start = 0;
+        _springTimestamp = 0;
+        _pacedOffset = _swipeOffset;
+        [previous removeClient:self];
+        [self.animationScheduler addClient:self frameRateRange:_frameRateRange adaptsToPowerState:_adaptsFrameRate];
+    }
+}
+
+- (void)setSwipeOffset:(CGFloat) newOffset;
+{
+    if (mgMetricsSink) {
+        CFTimeInterval metricsStart = CACurrentMediaTime();
+        [self layoutSwipeOffset:newOffset];
+        mgMetricsRecordDuration(MGSwipeMetricSetSwipeOffsetDuration, metricsStart);
+    }
     else {
-        CGFloat maxOffset = sign * activeButtons.bounds.size.width;
-        _swipeOffset = sign > 0 ? MIN(newOffset, maxOffset) : MAX(newOffset, maxOffset);
+        [self layoutSwipeOffset:newOffset];
     }
-    CGFloat offset = fabs(_swipeOffset);
-  
+    if (_coalescesSwipeEvents && [self delegateResponds:MGSwipeDelegateCapabilityDidReceiveSwipeEvents]) {
+        [self enqueueSwipeEvent:MGSwipeEventKindOffset];
+    }
+}
+
+-(MGSwipeConfig) swipeMachineConfig
+{
+    MGSwipeConfig config;
+    MGSwipeButtonsView * views[2] = {_leftView, _rightView};
+    MGSwipeSettings * settings[2] = {_leftSwipeSettings, _rightSwipeSettings};
+    MGSwipeExpansionSettings * expansions[2] = {_leftExpansion, _rightExpansion};
+    bool allowed[2] = {_allowSwipeLeftToRight, _allowSwipeRightToLeft};
+    for (int i = 0; i < 2; ++i) {
+        config.sides[i] = (MGSwipeSideConfig) {
+            .buttonsWidth = views[i] ? views[i].bounds.size.width : 0,
+            .allowed = allowed[i],
+            .enableBounces = settings[i].enableSwipeBounces,
+            .bounceRate = settings[i].swipeBounceRate,
+            .threshold = settings[i].threshold,
+            .keepButtonsSwiped = settings[i].keepButtonsSwiped,
+            .expansionIndex = expansions[i].buttonIndex,
+            .expansionThreshold = expansions[i].threshold,
+            .fillOnTrigger = expansions[i].fillOnTrigger
+        };
+    }
+    config.cellWidth = self.bounds.size.width;
+    config.allowsOppositeSwipe = _allowsOppositeSwipe;
+    config.inertiaThreshold = 100.0; //points per second
+    return config;
+}
+
+-(void) layoutSwipeOffset:(CGFloat) newOffset
+{
+    //buttons and settings may change between frames, the machine always decides with the current ones
+    _machine.config = [self swipeMachineConfig];
+    mgSwipeMachineSetOffset(&_machine, newOffset);
+    _swipeOffset = _machine.offset;
   
-    if (!activeButtons || offset == 0) {
+    if (_machine.state == MGSwipeCoreStateNone) {
         if (_leftView)
             [_leftView endExpansionAnimated:NO];
         if (_rightView)
             [_rightView endExpansionAnimated:NO];
         [self hideSwipeOverlayIfNeededIncludingReselect:true];
-        _targetOffset = 0;
         [self updateState:MGSwipeStateNone];
         return;
     }
-    else {
-        [self showSwipeOverlayIfNeeded];
-        CGFloat swipeThreshold = activeSettings.threshold;
-        BOOL keepButtons = activeSettings.keepButtonsSwiped;
-        _targetOffset = keepButtons && offset > activeButtons.bounds.size.width * swipeThreshold ? activeButtons.bounds.size.width * sign : 0;
-    }
+    [self showSwipeOverlayIfNeeded];
+
+    CGFloat sign = _swipeOffset > 0 ? 1.0 : -1.0;
+    CGFloat offset = fabs(_swipeOffset);
+    MGSwipeButtonsView * activeButtons = sign < 0 ? _rightView : _leftView;
+    MGSwipeSettings * activeSettings = sign < 0 ? _rightSwipeSettings : _leftSwipeSettings;
     
     BOOL onlyButtons = activeSettings.onlySwipeButtons;
     UIEdgeInsets safeInsets = [self getSafeInsets];
@@ -1173,27 +2889,25 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
         view.transform = CGAffineTransformMakeTranslation(translation, 0);
 
         if (view != activeButtons) continue; //only transition if active (perf. improvement)
-        bool expand = expansions[i].buttonIndex >= 0 && offset > view.bounds.size.width * expansions[i].threshold;
-        if (expand) {
+        if (mgSwipeMachineIsExpanding(&_machine)) {
             [view expandToOffset:offset settings:expansions[i]];
-            _targetOffset = expansions[i].fillOnTrigger ? self.bounds.size.width * sign : 0;
             _activeExpansion = view;
-            [self updateState:i ? MGSwipeStateExpandingRightToLeft : MGSwipeStateExpandingLeftToRight];
         }
         else {
             [view endExpansionAnimated:YES];
             _activeExpansion = nil;
             CGFloat t = MIN(1.0f, offset/view.bounds.size.width);
             [view transition:settings[i].transition percent:t];
-            [self updateState:i ? MGSwipeStateSwipingRightToLeft : MGSwipeStateSwipingLeftToRight];
         }
+        [self updateState:(MGSwipeState) _machine.state];
     }
 }
 
 -(void) hideSwipeAnimated: (BOOL) animated completion:(void(^)(BOOL finished)) completion
 {
-    MGSwipeAnimation * animation = animated ? (_swipeOffset > 0 ? _leftSwipeSettings.hideAnimation: _rightSwipeSettings.hideAnimation) : nil;
-    [self setSwipeOffset:0 animation:animation completion:completion];
+    MGSwipeSettings * settings = _swipeOffset > 0 ? _leftSwipeSettings : _rightSwipeSettings;
+    MGSwipeAnimation * animation = animated ? settings.hideAnimation : nil;
+    [self setSwipeOffset:0 settings:settings animation:animation velocity:_springing ? _spring.velocity : 0 completion:completion];
 }
 
 -(void) hideSwipeAnimated: (BOOL) animated
@@ -1215,8 +2929,9 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     
     if (buttonsView) {
         CGFloat s = direction == MGSwipeDirectionLeftToRight ? 1.0 : -1.0;
-        MGSwipeAnimation * animation = animated ? (direction == MGSwipeDirectionLeftToRight ? _leftSwipeSettings.showAnimation : _rightSwipeSettings.showAnimation) : nil;
-        [self setSwipeOffset:buttonsView.bounds.size.width * s animation:animation completion:completion];
+        MGSwipeSettings * settings = direction == MGSwipeDirectionLeftToRight ? _leftSwipeSettings : _rightSwipeSettings;
+        MGSwipeAnimation * animation = animated ? settings.showAnimation : nil;
+        [self setSwipeOffset:buttonsView.bounds.size.width * s settings:settings animation:animation velocity:_springing ? _spring.velocity : 0 completion:completion];
     }
 }
 
@@ -1243,28 +2958,68 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     }
 }
 
--(void) animationTick: (CADisplayLink *) timer
+-(void) advanceAnimation:(CFTimeInterval) timestamp
 {
+    if (_springing) {
+        [self advanceSpring:timestamp];
+        return;
+    }
     if (!_animationData.start) {
-        _animationData.start = timer.timestamp;
+        _animationData.start = timestamp;
     }
-    CFTimeInterval elapsed = timer.timestamp - _animationData.start;
+    CFTimeInterval elapsed = timestamp - _animationData.start;
     bool completed = elapsed >= _animationData.duration;
+    CGFloat offset = [_animationData.animation value:elapsed duration:_animationData.duration from:_animationData.from to:_animationData.to];
+    if (mgFramePacingShouldSkip(_pacedOffset, offset, _minimumOffsetDelta, completed)) {
+        return;
+    }
     if (completed) {
         _triggerStateChanges = YES;
     }
-    self.swipeOffset = [_animationData.animation value:elapsed duration:_animationData.duration from:_animationData.from to:_animationData.to];
+    _pacedOffset = offset;
+    self.swipeOffset = offset;
     
-    //call animation completion and invalidate timer
+    //call animation completion and stop the animation
     if (completed){
-        [timer invalidate];
-        [self invalidateDisplayLink];
+        [self invalidateAnimation];
     }
 }
 
--(void)invalidateDisplayLink {
-    [_displayLink invalidate];
-    _displayLink = nil;
+-(void) advanceSpring:(CFTimeInterval) timestamp
+{
+    CFTimeInterval dt = _springTimestamp ? timestamp - _springTimestamp : 0;
+    _springTimestamp = timestamp;
+    mgSpringStepToTarget(&_spring, dt);
+    bool completed = mgSpringIsSettled(&_spring);
+    if (completed) {
+        _triggerStateChanges = YES;
+        self.swipeOffset = _spring.target;
+        [self invalidateAnimation];
+    }
+    else if (!mgFramePacingShouldSkip(_pacedOffset, _spring.position, _minimumOffsetDelta, false)) {
+        _pacedOffset = _spring.position;
+        self.swipeOffset = _spring.position;
+    }
+}
+
+/** Frame pacing of the animation towards offset, from the settings of the side it moves through */
+-(void) setFramePacingForAnimation:(MGSwipeAnimation *) animation offset:(CGFloat) offset
+{
+    MGSwipeSettings * settings = (offset != 0 ? offset : _swipeOffset) > 0 ? _leftSwipeSettings : _rightSwipeSettings;
+    _frameRateRange = animation.frameRateRange;
+    _adaptsFrameRate = settings.adaptsFrameRateToPowerState;
+    _minimumOffsetDelta = settings.minimumOffsetDelta;
+    if (_animating) { //already registered, e.g. retargeting a spring
+        [self.animationScheduler setFrameRateRange:_frameRateRange adaptsToPowerState:_adaptsFrameRate forClient:self];
+    }
+}
+
+-(void) invalidateAnimation {
+    if (_animating) {
+        [self.animationScheduler removeClient:self];
+        _animating = NO;
+    }
+    _springing = NO;
     if (_animationCompletion) {
         void (^callbackCopy)(BOOL finished) = _animationCompletion; //copy to avoid duplicated callbacks
         _animationCompletion = nil;
@@ -1274,16 +3029,22 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
 
 -(void) setSwipeOffset:(CGFloat)offset animated: (BOOL) animated completion:(void(^)(BOOL finished)) completion
 {
-    MGSwipeAnimation * animation = animated ? [[MGSwipeAnimation alloc] init] : nil;
+    static MGSwipeAnimation * defaultAnimation = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        defaultAnimation = [[MGSwipeAnimation alloc] init]; //only read by the animation, shared by all the cells
+    });
+    MGSwipeAnimation * animation = animated ? defaultAnimation : nil;
     [self setSwipeOffset:offset animation:animation completion:completion];
 }
 
 -(void) setSwipeOffset:(CGFloat)offset animation: (MGSwipeAnimation *) animation completion:(void(^)(BOOL finished)) completion
 {
-    if (_displayLink) {
-        [_displayLink invalidate];
-        _displayLink = nil;
+    if (_animating) {
+        [self.animationScheduler removeClient:self];
+        _animating = NO;
     }
+    _springing = NO;
     if (_animationCompletion) { //notify previous animation cancelled
         void (^callbackCopy)(BOOL finished) = _animationCompletion; //copy to avoid duplicated callbacks
         _animationCompletion = nil;
@@ -1303,13 +3064,64 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     
     _animationCompletion = completion;
     _triggerStateChanges = NO;
+    if (!_animationData) {
+        _animationData = [[MGSwipeAnimationData alloc] init];
+    }
     _animationData.from = _swipeOffset;
     _animationData.to = offset;
+    _pacedOffset = _swipeOffset;
     _animationData.duration = animation.duration;
     _animationData.start = 0;
     _animationData.animation = animation;
-    _displayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(animationTick:)];
-    [_displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+    [self setFramePacingForAnimation:animation offset:offset];
+    _animating = YES;
+    [self.animationScheduler addClient:self frameRateRange:_frameRateRange adaptsToPowerState:_adaptsFrameRate];
+}
+
+-(void) setSwipeOffset:(CGFloat)offset springResponse:(CGFloat) response velocity:(CGFloat) velocity completion:(void(^)(BOOL finished)) completion
+{
+    if (offset !=0) {
+        [self createSwipeViewIfNeeded];
+    }
+    if (_springing) {
+        //retarget in place: keep the position, velocity and the scheduler registration
+        mgSpringRetarget(&_spring, offset);
+        _spring.omega = 6.283185307179586 / MAX(response, 0.01);
+    }
+    else {
+        if (_animating) { //running a timed animation, continue from its current offset
+            [self.animationScheduler removeClient:self];
+            _animating = NO;
+        }
+        mgSpringInit(&_spring, _swipeOffset, velocity, offset, response);
+        _springTimestamp = 0;
+        _pacedOffset = _swipeOffset;
+    }
+    if (_animationCompletion) { //notify previous animation cancelled
+        void (^callbackCopy)(BOOL finished) = _animationCompletion; //copy to avoid duplicated callbacks
+        _animationCompletion = nil;
+        callbackCopy(NO);
+    }
+    _animationCompletion = completion;
+    _triggerStateChanges = NO;
+    if (!_springing) {
+        _springing = YES;
+        _animating = YES;
+        [self.animationScheduler addClient:self frameRateRange:_frameRateRange adaptsToPowerState:_adaptsFrameRate];
+    }
+}
+
+/** Animates with the spring if the settings use MGSwipeAnimationModeSpring, with the timed animation otherwise */
+-(void) setSwipeOffset:(CGFloat)offset settings:(MGSwipeSettings *) settings animation:(MGSwipeAnimation *) animation
+              velocity:(CGFloat) velocity completion:(void(^)(BOOL finished)) completion
+{
+    if (animation && settings.animationMode == MGSwipeAnimationModeSpring) {
+        [self setFramePacingForAnimation:animation offset:offset];
+        [self setSwipeOffset:offset springResponse:settings.springResponse velocity:velocity completion:completion];
+    }
+    else {
+        [self setSwipeOffset:offset animation:animation completion:completion];
+    }
 }
 
 #pragma mark Gestures
@@ -1328,7 +3140,7 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
 -(void) tapHandler: (UITapGestureRecognizer *) recognizer
 {
     BOOL hide = YES;
-    if (_delegate && [_delegate respondsToSelector:@selector(swipeTableCell:shouldHideSwipeOnTap:)]) {
+    if ([self delegateResponds:MGSwipeDelegateCapabilityShouldHideSwipeOnTap]) {
         hide = [_delegate swipeTableCell:self shouldHideSwipeOnTap:[recognizer locationInView:self]];
     }
     if (hide) {
@@ -1336,55 +3148,39 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     }
 }
 
--(CGFloat) filterSwipe: (CGFloat) offset
-{
-    bool allowed = offset > 0 ? _allowSwipeLeftToRight : _allowSwipeRightToLeft;
-    UIView * buttons = offset > 0 ? _leftView : _rightView;
-    if (!buttons || ! allowed) {
-        offset = 0;
-    }
-    else if (!_allowsOppositeSwipe && _firstSwipeState == MGSwipeStateSwipingLeftToRight && offset < 0) {
-        offset = 0;
-    }
-    else if (!_allowsOppositeSwipe && _firstSwipeState == MGSwipeStateSwipingRightToLeft && offset > 0 ) {
-        offset = 0;
-    }
-    return offset;
-}
-
 -(void) panHandler: (UIPanGestureRecognizer *)gesture
 {
     CGPoint current = [gesture translationInView:self];
     
     if (gesture.state == UIGestureRecognizerStateBegan) {
-        [self invalidateDisplayLink];
+        [self invalidateAnimation];
 
         if (!_preservesSelectionStatus)
             self.highlighted = NO;
         [self createSwipeViewIfNeeded];
-        _panStartPoint = current;
-        _panStartOffset = _swipeOffset;
-        if (_swipeOffset != 0) {
-            _firstSwipeState = _swipeOffset > 0 ? MGSwipeStateSwipingLeftToRight : MGSwipeStateSwipingRightToLeft;
-        }
+        _machine.config = [self swipeMachineConfig];
+        mgSwipeMachinePanBegan(&_machine, current.x);
         
-        if (!_allowsMultipleSwipe) {
-            NSArray * cells = [self parentTable].visibleCells;
-            for (MGSwipeTableCell * cell in cells) {
-                if ([cell isKindOfClass:[MGSwipeTableCell class]] && cell != self) {
-                    [cell cancelPanGesture];
-                }
+        UITableView * table = [self parentTable];
+        if (table) {
+            //the coordinator tracks the swiped and swiping cells, no need to scan the visible cells
+            MGSwipeTableCoordinator * coordinator = [MGSwipeTableCoordinator coordinatorForTableView:table];
+            if (!_allowsMultipleSwipe) {
+                [coordinator cancelPanGesturesExceptCell:self];
             }
+            [coordinator activateCell:self];
         }
     }
     else if (gesture.state == UIGestureRecognizerStateChanged) {
-        CGFloat offset = _panStartOffset + current.x - _panStartPoint.x;
-        if (_firstSwipeState == MGSwipeStateNone) {
-            _firstSwipeState = offset > 0 ? MGSwipeStateSwipingLeftToRight : MGSwipeStateSwipingRightToLeft;
-        }
-        self.swipeOffset = [self filterSwipe:offset];
+        self.swipeOffset = mgSwipeMachinePanOffset(&_machine, current.x);
     }
     else {
+        CGFloat velocity = [_panRecognizer velocityInView:self].x;
+        MGSwipeSettings * settings = _swipeOffset > 0 ? _leftSwipeSettings : _rightSwipeSettings;
+        BOOL spring = settings.animationMode == MGSwipeAnimationModeSpring;
+        //spring mode predicts where the flick would rest and springs to the closest resting offset from there
+        MGSwipeReleaseAnimation release = spring ? mgSwipeMachineSpringEnded(&_machine, velocity, UIScrollViewDecelerationRateNormal)
+                                                 : mgSwipeMachinePanEnded(&_machine, velocity);
         __weak MGSwipeButtonsView * expansion = _activeExpansion;
         if (expansion) {
             __weak UIView * expandedButton = [expansion getExpandedButton];
@@ -1394,7 +3190,7 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
                 backgroundColor = expansion.backgroundColorCopy; //keep expansion background color
                 expansion.backgroundColorCopy = expSettings.expansionColor;
             }
-            [self setSwipeOffset:_targetOffset animation:expSettings.triggerAnimation completion:^(BOOL finished){
+            [self setSwipeOffset:_machine.targetOffset animation:expSettings.triggerAnimation completion:^(BOOL finished){
                 if (!finished || self.hidden || !expansion) {
                     return; //cell might be hidden after a delete row animation without being deallocated (to be reused later)
                 }
@@ -1407,32 +3203,25 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
                 }
             }];
         }
+        else if (spring) {
+            MGSwipeAnimation * pacing = release == MGSwipeReleaseAnimationHide ? settings.hideAnimation : settings.showAnimation;
+            [self setFramePacingForAnimation:pacing offset:_machine.targetOffset];
+            [self setSwipeOffset:_machine.targetOffset springResponse:settings.springResponse velocity:velocity completion:nil];
+        }
         else {
-            CGFloat velocity = [_panRecognizer velocityInView:self].x;
-            CGFloat inertiaThreshold = 100.0; //points per second
-            
-            if (velocity > inertiaThreshold) {
-                _targetOffset = _swipeOffset < 0 ? 0 : (_leftView  && _leftSwipeSettings.keepButtonsSwiped ? _leftView.bounds.size.width : _targetOffset);
-            }
-            else if (velocity < -inertiaThreshold) {
-                _targetOffset = _swipeOffset > 0 ? 0 : (_rightView && _rightSwipeSettings.keepButtonsSwiped ? -_rightView.bounds.size.width : _targetOffset);
-            }
-            _targetOffset = [self filterSwipe:_targetOffset];
-            MGSwipeSettings * settings = _swipeOffset > 0 ? _leftSwipeSettings : _rightSwipeSettings;
             MGSwipeAnimation * animation = nil;
-            if (_targetOffset == 0) {
-                animation = settings.hideAnimation;
-            }
-            else if (fabs(_swipeOffset) > fabs(_targetOffset)) {
-                animation = settings.stretchAnimation;
+            switch (release) {
+                case MGSwipeReleaseAnimationHide: animation = settings.hideAnimation; break;
+                case MGSwipeReleaseAnimationStretch: animation = settings.stretchAnimation; break;
+                case MGSwipeReleaseAnimationShow: animation = settings.showAnimation; break;
             }
-            else {
-                animation = settings.showAnimation;
-            }
-            [self setSwipeOffset:_targetOffset animation:animation completion:nil];
+            [self setSwipeOffset:_machine.targetOffset animation:animation completion:nil];
         }
         
-        _firstSwipeState = MGSwipeStateNone;
+        UITableView * table = [self parentTable];
+        if (!_overlayEnabled && table) {
+            [[MGSwipeTableCoordinator coordinatorForTableView:table] deactivateCell:self];
+        }
     }
 }
 
@@ -1460,12 +3249,12 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
         }
         
         //make a decision according to existing buttons or using the optional delegate
-        if (_delegate && [_delegate respondsToSelector:@selector(swipeTableCell:canSwipe:fromPoint:)]) {
+        if ([self delegateResponds:MGSwipeDelegateCapabilityCanSwipeFromPoint]) {
             CGPoint point = [_panRecognizer locationInView:self];
             _allowSwipeLeftToRight = [_delegate swipeTableCell:self canSwipe:MGSwipeDirectionLeftToRight fromPoint:point];
             _allowSwipeRightToLeft = [_delegate swipeTableCell:self canSwipe:MGSwipeDirectionRightToLeft fromPoint:point];
         }
-        else if (_delegate && [_delegate respondsToSelector:@selector(swipeTableCell:canSwipe:)]) {
+        else if ([self delegateResponds:MGSwipeDelegateCapabilityCanSwipe]) {
             #pragma clang diagnostic push
             #pragma clang diagnostic ignored "-Wdeprecated-declarations"
             _allowSwipeLeftToRight = [_delegate swipeTableCell:self canSwipe:MGSwipeDirectionLeftToRight];
@@ -1474,8 +3263,8 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
         }
         else {
             [self fetchButtonsIfNeeded];
-            _allowSwipeLeftToRight = _leftButtons.count > 0;
-            _allowSwipeRightToLeft = _rightButtons.count > 0;
+            _allowSwipeLeftToRight = _leftButtons.count > 0 || _leftDescriptors.count > 0;
+            _allowSwipeRightToLeft = _rightButtons.count > 0 || _rightDescriptors.count > 0;
         }
         
         return (_allowSwipeLeftToRight && translation.x > 0) || (_allowSwipeRightToLeft && translation.x < 0);
@@ -1487,6 +3276,21 @@ static inline CGFloat mgEaseInOutBounce(CGFloat t, CGFloat b, CGFloat c) {
     return YES;
 }
 
++(void) setMetricsSink:(id<MGSwipeMetricsSink>) metricsSink
+{
+    mgMetricsSink = metricsSink;
+}
+
++(id<MGSwipeMetricsSink>) metricsSink
+{
+    return mgMetricsSink;
+}
+
+-(NSUInteger) transitionMaskLayers
+{
+    return _leftView.transitionMaskLayers + _rightView.transitionMaskLayers;
+}
+
 -(BOOL) isSwipeGestureActive
 {
     return _panRecognizer.state == UIGestureRecognizerStateBegan || _panRecognizer.state == UIGestureRecognizerStateChanged;
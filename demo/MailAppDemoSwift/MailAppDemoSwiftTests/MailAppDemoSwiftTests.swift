@@ -9,15 +9,33 @@
 import UIKit
 import XCTest
 
+/// Returns one button per direction, optionally customizing the settings handed to it
+class SettingsDelegate: NSObject, MGSwipeTableCellDelegate {
+    var customizes = false
+    var keptSettings: MGSwipeSettings?
+
+    func swipeTableCell(_ cell: MGSwipeTableCell, swipeButtonsFor direction: MGSwipeDirection, swipeSettings: MGSwipeSettings, expansionSettings: MGSwipeExpansionSettings) -> [UIView]? {
+        if customizes {
+            swipeSettings.transition = .drag
+        }
+        if direction == .leftToRight {
+            keptSettings = swipeSettings
+        }
+        return [MGSwipeButton(title: "Delete", backgroundColor: UIColor.red)]
+    }
+}
+
 class MailAppDemoSwiftTests: XCTestCase {
     
+    let recorder = MGSwipeMetricsRecorder(capacity: 1024)
+    
     override func setUp() {
         super.setUp()
-        // Put setup code here. This method is called before the invocation of each test method in the class.
+        MGSwipeTableCell.metricsSink = recorder
     }
     
     override func tearDown() {
-        // Put teardown code here. This method is called after the invocation of each test method in the class.
+        MGSwipeTableCell.metricsSink = nil
         super.tearDown()
     }
     
@@ -33,4 +51,65 @@ class MailAppDemoSwiftTests: XCTestCase {
         }
     }
     
+    /// Settings and animation objects allocated (count, bytes) since the last call
+    func settingsAllocations() -> (Double, Double) {
+        recorder.drain()
+        let allocations = (recorder.total(for: .settingsAllocations), recorder.total(for: .settingsBytes))
+        recorder.reset()
+        return allocations
+    }
+    
+    func swipe(_ cells: [MGSwipeTableCell]) {
+        for cell in cells {
+            cell.showSwipe(.leftToRight, animated: false)
+            cell.hideSwipe(animated: false)
+        }
+    }
+    
+    func testSettingsAllocations() {
+        let delegate = SettingsDelegate()
+        let cells = (0..<20).map { _ -> MGSwipeTableCell in
+            let cell = MGSwipeTableCell(style: .default, reuseIdentifier: "cell")
+            cell.delegate = delegate
+            return cell
+        }
+        let settingsBytes = Double(class_getInstanceSize(MGSwipeSettings.self))
+        let expansionBytes = Double(class_getInstanceSize(MGSwipeExpansionSettings.self))
+        XCTAssertTrue(settingsAllocations() == (0, 0), "cells share the default settings")
+        
+        // the first fetch allocates the copies handed to the delegate, one settings and one expansion per direction
+        swipe(cells)
+        let fetched = settingsAllocations()
+        XCTAssertEqual(fetched.0, 20 * 4)
+        XCTAssertEqual(fetched.1, 20 * 2 * (settingsBytes + expansionBytes))
+        print("settings allocated by the first swipe of a cell: \(fetched.0 / 20) objects, \(fetched.1 / 20) bytes")
+        
+        // unchanged copies are handed out again after reuse
+        cells.forEach { $0.prepareForReuse() }
+        swipe(cells)
+        XCTAssertTrue(settingsAllocations() == (0, 0), "reuse and fetch without customization allocate nothing")
+        
+        // customized copies are kept by the cell, reuse goes back to the shared defaults and the next fetch needs new copies
+        delegate.customizes = true
+        cells.forEach { $0.prepareForReuse() }
+        swipe(cells)
+        XCTAssertEqual(settingsAllocations().0, 0, "the copies of the previous fetch are customized")
+        cells.forEach { $0.prepareForReuse() }
+        swipe(cells)
+        XCTAssertEqual(settingsAllocations().0, 20 * 2)
+    }
+    
+    func testSettingsCustomizedAfterFetch() {
+        let delegate = SettingsDelegate()
+        let cell = MGSwipeTableCell(style: .default, reuseIdentifier: "cell")
+        cell.delegate = delegate
+        cell.showSwipe(.leftToRight, animated: false)
+        cell.hideSwipe(animated: false)
+        // the delegate keeps the copy and customizes it later, it's adopted by the next swipe
+        let kept = delegate.keptSettings!
+        kept.showAnimation.duration = 1
+        cell.showSwipe(.leftToRight, animated: false)
+        XCTAssertTrue(cell.leftSwipeSettings === kept)
+    }
+    
 }
@@ -0,0 +1,25 @@
+/*
+ * Minimal benchmark helpers for the MGSwipeCore benchmarks
+ */
+
+#ifndef MGSwipeBench_h
+#define MGSwipeBench_h
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <time.h>
+
+static inline double mgBenchNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/** Keeps the benchmarked results alive */
+static volatile double mgBenchSink;
+
+static inline void mgBenchReport(const char * name, double seconds, double operations, const char * unit) {
+    printf("%-44s %10.2f ns/%s  (%.0f %ss in %.3f s)\n", name, seconds * 1e9 / operations, unit, operations, unit, seconds);
+}
+
+#endif /* MGSwipeBench_h */
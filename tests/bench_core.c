@@ -0,0 +1,251 @@
+/*
+ * Headless benchmarks of MGSwipeCore.h, driven by simulated clocks
+ */
+
+#include "bench.h"
+#include "../MGSwipeTableCell/MGSwipeCore.h"
+
+/* Easing Curves */
+
+/** Same values as MGSwipeEasingFunction */
+typedef enum BenchEasing {
+    BenchEasingLinear = 0, BenchEasingQuadIn, BenchEasingQuadOut, BenchEasingQuadInOut, BenchEasingCubicIn, BenchEasingCubicOut,
+    BenchEasingCubicInOut, BenchEasingBounceIn, BenchEasingBounceOut, BenchEasingBounceInOut
+} BenchEasing;
+
+/** The easing path before the curves were resolved: a switch and an indirect call on every value */
+static double benchPerCallValue(BenchEasing easing, double elapsed, double duration, double from, double to) {
+    const double t = fmin(elapsed / duration, 1.0);
+    MGEasingFunction function = NULL;
+    switch (easing) {
+        case BenchEasingLinear: function = mgEaseLinear; break;
+        case BenchEasingQuadIn: function = mgEaseInQuad; break;
+        case BenchEasingQuadOut: function = mgEaseOutQuad; break;
+        case BenchEasingQuadInOut: function = mgEaseInOutQuad; break;
+        case BenchEasingCubicIn: function = mgEaseInCubic; break;
+        case BenchEasingCubicOut: function = mgEaseOutCubic; break;
+        case BenchEasingCubicInOut: function = mgEaseInOutCubic; break;
+        case BenchEasingBounceIn: function = mgEaseInBounce; break;
+        case BenchEasingBounceOut: function = mgEaseOutBounce; break;
+        case BenchEasingBounceInOut: function = mgEaseInOutBounce; break;
+    }
+    return (*function)(t, from, to - from);
+}
+
+#define BENCH_EASING_VALUES 4096
+#define BENCH_EASING_ROUNDS 2000
+
+/** Evaluates the curve per call and in batches for BENCH_EASING_VALUES animations, BENCH_EASING_ROUNDS times */
+static void benchEasing(const char * name, const MGEasingCurve * curve, int easing) {
+    static double elapsed[BENCH_EASING_VALUES], from[BENCH_EASING_VALUES], to[BENCH_EASING_VALUES], values[BENCH_EASING_VALUES];
+    const double duration = 0.3;
+    for (int i = 0; i < BENCH_EASING_VALUES; ++i) {
+        elapsed[i] = duration * (i % 97) / 96.0;
+        from[i] = i % 320;
+        to[i] = 0;
+    }
+    const double operations = (double) BENCH_EASING_VALUES * BENCH_EASING_ROUNDS;
+    char label[64];
+    double sum = 0;
+    /* the easing is read through a volatile so the per call switch isn't resolved at compile time, like in the old MGSwipeAnimation */
+    volatile int easingSource = easing;
+    if (easing >= 0) {
+        double start = mgBenchNow();
+        for (int round = 0; round < BENCH_EASING_ROUNDS; ++round) {
+            const BenchEasing perCall = (BenchEasing) easingSource;
+            for (int i = 0; i < BENCH_EASING_VALUES; ++i) {
+                sum += benchPerCallValue(perCall, elapsed[i], duration, from[i], to[i]);
+            }
+        }
+        snprintf(label, sizeof(label), "easing %s, per call switch", name);
+        mgBenchReport(label, mgBenchNow() - start, operations, "value");
+    }
+    double start = mgBenchNow();
+    for (int round = 0; round < BENCH_EASING_ROUNDS; ++round) {
+        for (int i = 0; i < BENCH_EASING_VALUES; ++i) {
+            sum += mgEasingCurveValue(curve, elapsed[i], duration, from[i], to[i]);
+        }
+    }
+    snprintf(label, sizeof(label), "easing %s, resolved curve", name);
+    mgBenchReport(label, mgBenchNow() - start, operations, "value");
+    start = mgBenchNow();
+    for (int round = 0; round < BENCH_EASING_ROUNDS; ++round) {
+        mgEasingCurveValues(curve, elapsed, from, to, values, BENCH_EASING_VALUES, duration);
+        sum += values[round % BENCH_EASING_VALUES];
+    }
+    snprintf(label, sizeof(label), "easing %s, batch", name);
+    mgBenchReport(label, mgBenchNow() - start, operations, "value");
+    mgBenchSink = sum;
+}
+
+static void benchEasingCurves(void) {
+    MGEasingCurve curve = {NULL, NULL, MGEasingKindFunction};
+    mgEasingCurveSetFunction(&curve, mgEaseOutCubic);
+    benchEasing("cubic out", &curve, BenchEasingCubicOut);
+    mgEasingCurveSetFunction(&curve, mgEaseInOutQuad);
+    benchEasing("quad in out", &curve, BenchEasingQuadInOut);
+    mgEasingCurveSetFunction(&curve, mgEaseOutBounce);
+    benchEasing("bounce out", &curve, BenchEasingBounceOut);
+    mgEasingCurveSetCubicBezier(&curve, 0.25, 0.1, 0.25, 1.0);
+    benchEasing("cubic bezier", &curve, -1);
+    mgEasingCurveSetSpring(&curve, 0.7, 0);
+    benchEasing("spring", &curve, -1);
+    mgEasingCurveFree(&curve);
+}
+
+/* Buttons Layout */
+
+/** The layout before the widths were cached: offsets recomputed from the widths and the distance on every frame */
+static void benchUncachedBorder(const double * widths, double * positions, size_t count, double distance, double t, double width, bool fromLeft) {
+    double offsetX = 0;
+    for (size_t i = 0; i < count; ++i) {
+        positions[i] = fromLeft ? (width - widths[i] - offsetX) * (1.0 - t) + offsetX : offsetX * t;
+        offsetX += widths[i] + (i + 1 == count ? 0 : distance);
+    }
+}
+
+/** One swipe of frames frames over count buttons: uncached pass, cached pass and visible range of a 375 points wide cell */
+static void benchLayout(size_t count, int frames) {
+    MGSwipeButtonsLayout layout;
+    mgSwipeButtonsLayoutInit(&layout, count, 2.0);
+    for (size_t i = 0; i < count; ++i) {
+        layout.widths[i] = 72.0;
+    }
+    mgSwipeButtonsLayoutUpdateOffsets(&layout);
+    const double width = layout.offsets[count - 1] + layout.widths[count - 1];
+    double * positions = (double *) malloc(count * sizeof(double));
+    const double operations = (double) frames;
+    double sum = 0;
+    char label[64];
+
+    double start = mgBenchNow();
+    for (int f = 0; f < frames; ++f) {
+        benchUncachedBorder(layout.widths, positions, count, layout.distance, (f % 100) / 99.0, width, true);
+        sum += positions[f % count];
+    }
+    snprintf(label, sizeof(label), "layout %zu buttons, uncached border", count);
+    mgBenchReport(label, mgBenchNow() - start, operations, "frame");
+
+    start = mgBenchNow();
+    for (int f = 0; f < frames; ++f) {
+        mgSwipeButtonsLayoutTransition(&layout, MGSwipeLayoutTransitionBorder, (f % 100) / 99.0, width, true);
+        sum += layout.positions[f % count];
+    }
+    snprintf(label, sizeof(label), "layout %zu buttons, cached border", count);
+    mgBenchReport(label, mgBenchNow() - start, operations, "frame");
+
+    start = mgBenchNow();
+    for (int f = 0; f < frames; ++f) {
+        const double t = (f % 100) / 99.0;
+        size_t first, end;
+        /* the cell shows the last 375 points of the strip while it's swiped */
+        mgSwipeButtonsLayoutVisibleRange(&layout, MGSwipeLayoutTransitionStatic, t, width, true, width - 375.0, width, &first, &end);
+        mgSwipeButtonsLayoutTransitionRange(&layout, MGSwipeLayoutTransitionStatic, t, width, true, first, end);
+        sum += layout.positions[first < count ? first : 0];
+    }
+    snprintf(label, sizeof(label), "layout %zu buttons, visible static range", count);
+    mgBenchReport(label, mgBenchNow() - start, operations, "frame");
+
+    mgBenchSink = sum;
+    free(positions);
+    mgSwipeButtonsLayoutFree(&layout);
+}
+
+/* Animation Ticker */
+
+/** Timed swipe animation, like the ones MGSwipeAnimationScheduler drives from the cells */
+typedef struct BenchAnimation {
+    MGAnimationTicker * ticker;
+    const MGEasingCurve * curve;
+    double from;
+    double to;
+    double start;
+    double duration;
+    double offset;
+    bool active;
+} BenchAnimation;
+
+static void benchAnimationTick(void * client, double timestamp) {
+    BenchAnimation * animation = (BenchAnimation *) client;
+    if (!animation->start) {
+        animation->start = timestamp;
+    }
+    const double elapsed = timestamp - animation->start;
+    animation->offset = mgEasingCurveValue(animation->curve, elapsed, animation->duration, animation->from, animation->to);
+    if (elapsed >= animation->duration) {
+        animation->active = false;
+        mgAnimationTickerRemove(animation->ticker, animation);
+    }
+}
+
+static void benchAnimationStart(BenchAnimation * animation, MGAnimationTicker * ticker, const MGEasingCurve * curve, size_t index) {
+    animation->ticker = ticker;
+    animation->curve = curve;
+    animation->from = (double) (index % 320);
+    animation->to = 0;
+    animation->start = 0;
+    animation->duration = 0.2 + (index % 16) * 0.01; /* staggered completions */
+    animation->active = true;
+    mgAnimationTickerAdd(ticker, animation);
+}
+
+/**
+ * Closes count cells at once and restarts each animation as soon as it finishes, for the given simulated seconds at 120 Hz.
+ * Shared: a single ticker advances all the animations per frame, like MGSwipeAnimationScheduler.
+ * Per animation: one ticker per animation, advanced one by one, like a CADisplayLink per cell.
+ */
+static void benchTicker(size_t count, bool shared) {
+    const double frame = 1.0 / 120.0;
+    const int frames = 1200;
+    MGEasingCurve curve = {NULL, NULL, MGEasingKindFunction};
+    mgEasingCurveSetFunction(&curve, mgEaseOutCubic);
+    BenchAnimation * animations = (BenchAnimation *) calloc(count, sizeof(BenchAnimation));
+    MGAnimationTicker * tickers = (MGAnimationTicker *) calloc(shared ? 1 : count, sizeof(MGAnimationTicker));
+    const size_t tickerCount = shared ? 1 : count;
+    for (size_t i = 0; i < tickerCount; ++i) {
+        mgAnimationTickerInit(&tickers[i], benchAnimationTick, NULL);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        benchAnimationStart(&animations[i], &tickers[shared ? 0 : i], &curve, i);
+    }
+    double animationFrames = 0;
+    const double start = mgBenchNow();
+    for (int f = 1; f <= frames; ++f) {
+        const double timestamp = f * frame;
+        for (size_t i = 0; i < tickerCount; ++i) {
+            animationFrames += tickers[i].active;
+            mgAnimationTickerAdvance(&tickers[i], timestamp);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (!animations[i].active) {
+                benchAnimationStart(&animations[i], &tickers[shared ? 0 : i], &curve, i + f);
+            }
+        }
+    }
+    const double seconds = mgBenchNow() - start;
+    double sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += animations[i].offset;
+    }
+    mgBenchSink = sum;
+    char name[64];
+    snprintf(name, sizeof(name), "ticker %s, %zu animations", shared ? "shared" : "per animation", count);
+    mgBenchReport(name, seconds, animationFrames, "frame");
+    for (size_t i = 0; i < tickerCount; ++i) {
+        mgAnimationTickerFree(&tickers[i]);
+    }
+    free(tickers);
+    free(animations);
+}
+
+int main(void) {
+    benchEasingCurves();
+    benchLayout(4, 5000000);
+    benchLayout(1000, 50000);
+    const size_t counts[] = {1000, 5000, 20000};
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        benchTicker(counts[i], true);
+        benchTicker(counts[i], false);
+    }
+    return 0;
+}
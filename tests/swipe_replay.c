@@ -0,0 +1,189 @@
+/*
+ * Replays synthetic touch traces through the swipe state machine of MGSwipeCore.h:
+ * checks the state sequences of known gestures, then measures the replay throughput.
+ * Usage: swipe_replay [gestures], 0 only runs the checks
+ */
+
+#include "bench.h"
+#include "test.h"
+#include <stdlib.h>
+#include "../MGSwipeTableCell/MGSwipeCore.h"
+
+#define REPLAY_FRAME (1.0 / 60.0)
+#define REPLAY_MAX_SAMPLES 256
+
+/** 3 buttons of 50 points on each side, only the left one expands */
+static MGSwipeConfig replayConfig(void) {
+    MGSwipeConfig config;
+    for (int i = 0; i < 2; ++i) {
+        config.sides[i] = (MGSwipeSideConfig) {
+            .buttonsWidth = 150, .allowed = true, .enableBounces = true, .bounceRate = 1.0, .threshold = 0.5,
+            .keepButtonsSwiped = true, .expansionIndex = i ? -1 : 0, .expansionThreshold = 1.5, .fillOnTrigger = true
+        };
+    }
+    config.cellWidth = 320;
+    config.allowsOppositeSwipe = true;
+    config.inertiaThreshold = 100;
+    return config;
+}
+
+/**
+ * Writes a pan moving linearly by distance in duration seconds, sampled every frame.
+ * The end velocity isn't recorded, the replay estimates it from the timestamps
+ */
+static size_t replayPan(MGSwipeTouchSample * samples, double distance, double duration) {
+    size_t count = 0;
+    const size_t frames = (size_t) fmax(1.0, round(duration / REPLAY_FRAME));
+    samples[count++] = (MGSwipeTouchSample) {MGSwipeTouchPhaseBegan, 0, 0, 0};
+    for (size_t frame = 1; frame <= frames; ++frame) {
+        const double t = (double) frame / frames;
+        samples[count++] = (MGSwipeTouchSample) {MGSwipeTouchPhaseChanged, distance * t, 0, duration * t};
+    }
+    samples[count++] = (MGSwipeTouchSample) {MGSwipeTouchPhaseEnded, distance, NAN, duration + REPLAY_FRAME};
+    samples[count - 1].position += distance / frames; //still moving when the finger lifts
+    return count;
+}
+
+/** Replays the pan from the given offset and checks the sequence of states */
+static void checkReplay(MGSwipeMachine * machine, double distance, double duration,
+                        const MGSwipeCoreState * expected, size_t expectedCount, double expectedOffset) {
+    MGSwipeTouchSample samples[REPLAY_MAX_SAMPLES];
+    MGSwipeCoreState states[8];
+    const size_t count = replayPan(samples, distance, duration);
+    const size_t changes = mgSwipeMachineReplay(machine, samples, count, states, 8);
+    CHECK(changes == expectedCount);
+    for (size_t i = 0; i < expectedCount && i < changes; ++i) {
+        CHECK(states[i] == expected[i]);
+    }
+    CHECK_NEAR(machine->offset, expectedOffset, 1e-9);
+    CHECK(machine->firstSwipeState == MGSwipeCoreStateNone);
+}
+
+static void testReplayKeepsButtons(void) {
+    MGSwipeConfig config = replayConfig();
+    MGSwipeMachine machine;
+    mgSwipeMachineInit(&machine, &config);
+    const MGSwipeCoreState open[] = {MGSwipeCoreStateSwipingLeftToRight};
+    checkReplay(&machine, 100, 2.0, open, 1, 150);
+    //a slow pan back over the threshold closes the buttons
+    const MGSwipeCoreState closed[] = {MGSwipeCoreStateNone};
+    checkReplay(&machine, -100, 2.0, closed, 1, 0);
+}
+
+static void testReplayBelowThreshold(void) {
+    MGSwipeConfig config = replayConfig();
+    MGSwipeMachine machine;
+    mgSwipeMachineInit(&machine, &config);
+    const MGSwipeCoreState expected[] = {MGSwipeCoreStateSwipingRightToLeft, MGSwipeCoreStateNone};
+    checkReplay(&machine, -40, 2.0, expected, 2, 0);
+}
+
+/** The same short pan closes when slow and opens when flicked, only the timestamps differ */
+static void testReplayFlick(void) {
+    MGSwipeConfig config = replayConfig();
+    MGSwipeMachine machine;
+    mgSwipeMachineInit(&machine, &config);
+    const MGSwipeCoreState slow[] = {MGSwipeCoreStateSwipingLeftToRight, MGSwipeCoreStateNone};
+    checkReplay(&machine, 30, 1.0, slow, 2, 0);
+    const MGSwipeCoreState flick[] = {MGSwipeCoreStateSwipingLeftToRight};
+    checkReplay(&machine, 30, 0.05, flick, 1, 150);
+
+    MGSwipeTouchSample samples[REPLAY_MAX_SAMPLES];
+    const size_t count = replayPan(samples, 30, 0.05);
+    CHECK_NEAR(mgSwipeTouchVelocity(samples, count - 1), 600, 1e-6);
+    samples[count - 1].velocity = -50;
+    CHECK(mgSwipeTouchVelocity(samples, count - 1) == -50);
+}
+
+static void testReplayExpansion(void) {
+    MGSwipeConfig config = replayConfig();
+    MGSwipeMachine machine;
+    mgSwipeMachineInit(&machine, &config);
+    const MGSwipeCoreState expected[] = {MGSwipeCoreStateSwipingLeftToRight, MGSwipeCoreStateExpandingLeftToRight};
+    checkReplay(&machine, 260, 1.0, expected, 2, 320);
+    //the right side has no expandable button, the pan is bounced
+    mgSwipeMachineInit(&machine, &config);
+    const MGSwipeCoreState right[] = {MGSwipeCoreStateSwipingRightToLeft};
+    checkReplay(&machine, -260, 2.0, right, 1, -150);
+}
+
+static void testReplayOppositeSwipe(void) {
+    MGSwipeConfig config = replayConfig();
+    config.allowsOppositeSwipe = false;
+    MGSwipeMachine machine;
+    mgSwipeMachineInit(&machine, &config);
+    mgSwipeMachineSetOffset(&machine, 150);
+    const MGSwipeCoreState expected[] = {MGSwipeCoreStateSwipingLeftToRight, MGSwipeCoreStateNone};
+    //closes while crossing 0, then stays closed instead of opening the right buttons
+    checkReplay(&machine, -300, 2.0, expected + 1, 1, 0);
+
+    config.allowsOppositeSwipe = true;
+    mgSwipeMachineInit(&machine, &config);
+    mgSwipeMachineSetOffset(&machine, 150);
+    CHECK(machine.state == expected[0]);
+    const MGSwipeCoreState opposite[] = {MGSwipeCoreStateNone, MGSwipeCoreStateSwipingRightToLeft};
+    checkReplay(&machine, -300, 2.0, opposite, 2, -150);
+}
+
+static void testSpringEnded(void) {
+    MGSwipeConfig config = replayConfig();
+    MGSwipeMachine machine;
+    mgSwipeMachineInit(&machine, &config);
+    mgSwipeMachinePanBegan(&machine, 0);
+    mgSwipeMachinePanChanged(&machine, 40);
+    //40 points is below the threshold, but the flick projects beyond it
+    CHECK(mgSwipeMachineSpringEnded(&machine, 600, 0.998) == MGSwipeReleaseAnimationShow);
+    CHECK(machine.targetOffset == 150);
+    mgSwipeMachinePanBegan(&machine, 0);
+    mgSwipeMachinePanChanged(&machine, 40);
+    CHECK(mgSwipeMachineSpringEnded(&machine, -100, 0.998) == MGSwipeReleaseAnimationHide);
+    CHECK(machine.targetOffset == 0);
+}
+
+/* Throughput */
+
+#define REPLAY_TRACES 64
+
+static void benchReplay(size_t gestures) {
+    static MGSwipeTouchSample trace[REPLAY_TRACES * REPLAY_MAX_SAMPLES];
+    size_t offsets[REPLAY_TRACES + 1];
+    unsigned int seed = 17;
+    offsets[0] = 0;
+    for (int i = 0; i < REPLAY_TRACES; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        const double distance = (double) (seed >> 16 & 0x1ff) - 256.0;
+        seed = seed * 1103515245u + 12345u;
+        const double duration = 0.05 + (seed >> 16 & 0xff) / 255.0;
+        offsets[i + 1] = offsets[i] + replayPan(trace + offsets[i], distance, duration);
+    }
+
+    MGSwipeConfig config = replayConfig();
+    MGSwipeMachine machine;
+    mgSwipeMachineInit(&machine, &config);
+    size_t changes = 0, samples = 0;
+    const double start = mgBenchNow();
+    for (size_t i = 0; i < gestures; ++i) {
+        const size_t index = i % REPLAY_TRACES;
+        const size_t count = offsets[index + 1] - offsets[index];
+        changes += mgSwipeMachineReplay(&machine, trace + offsets[index], count, NULL, 0);
+        samples += count;
+    }
+    const double seconds = mgBenchNow() - start;
+    mgBenchSink = (double) changes + machine.offset;
+    mgBenchReport("swipe replay", seconds, (double) gestures, "gesture");
+    mgBenchReport("swipe replay", seconds, (double) samples, "sample");
+}
+
+int main(int argc, char ** argv) {
+    RUN(testReplayKeepsButtons);
+    RUN(testReplayBelowThreshold);
+    RUN(testReplayFlick);
+    RUN(testReplayExpansion);
+    RUN(testReplayOppositeSwipe);
+    RUN(testSpringEnded);
+    const size_t gestures = argc > 1 ? strtoul(argv[1], NULL, 10) : 4000000;
+    if (!mgTestFailures && gestures > 0) {
+        benchReplay(gestures);
+    }
+    return mgTestFailures ? 1 : 0;
+}
@@ -0,0 +1,34 @@
+/*
+ * Minimal test helpers for the MGSwipeCore tests
+ */
+
+#ifndef MGSwipeTest_h
+#define MGSwipeTest_h
+
+#include <math.h>
+#include <stdio.h>
+
+static int mgTestFailures = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+        mgTestFailures++; \
+    } \
+} while (0)
+
+#define CHECK_NEAR(a, b, tolerance) do { \
+    const double mgA = (a), mgB = (b); \
+    if (!(fabs(mgA - mgB) <= (tolerance))) { \
+        fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s) failed: %g != %g\n", __FILE__, __LINE__, #a, #b, mgA, mgB); \
+        mgTestFailures++; \
+    } \
+} while (0)
+
+#define RUN(test) do { \
+    const int mgFailures = mgTestFailures; \
+    test(); \
+    printf("%s %s\n", mgFailures == mgTestFailures ? "ok  " : "FAIL", #test); \
+} while (0)
+
+#endif /* MGSwipeTest_h */
@@ -0,0 +1,435 @@
+/*
+ * Unit tests of MGSwipeCore.h
+ */
+
+#include "test.h"
+#include "../MGSwipeTableCell/MGSwipeCore.h"
+
+/* Easing Curves */
+
+static const MGEasingFunction testFunctions[] = {
+    mgEaseLinear, mgEaseInQuad, mgEaseOutQuad, mgEaseInOutQuad, mgEaseInCubic, mgEaseOutCubic, mgEaseInOutCubic,
+    mgEaseInBounce, mgEaseOutBounce, mgEaseInOutBounce
+};
+
+#define TEST_BATCH_SIZE 203
+
+/** The batch evaluation must match the per value one for every curve, including elapsed times out of [0, duration] */
+static void testEasingBatchMatchesScalar(const MGEasingCurve * curve) {
+    const double duration = 0.3;
+    double elapsed[TEST_BATCH_SIZE], from[TEST_BATCH_SIZE], to[TEST_BATCH_SIZE], values[TEST_BATCH_SIZE];
+    for (int i = 0; i < TEST_BATCH_SIZE; ++i) {
+        elapsed[i] = duration * (i - 10) / (TEST_BATCH_SIZE - 30);
+        from[i] = i % 7 * 40.0 - 100.0;
+        to[i] = i % 5 * -30.0 + 50.0;
+    }
+    mgEasingCurveValues(curve, elapsed, from, to, values, TEST_BATCH_SIZE, duration);
+    for (int i = 0; i < TEST_BATCH_SIZE; ++i) {
+        CHECK_NEAR(values[i], mgEasingCurveValue(curve, elapsed[i], duration, from[i], to[i]), 1e-9);
+        if (elapsed[i] >= duration) {
+            CHECK(values[i] == to[i]);
+        }
+    }
+}
+
+static void testEasingFunctions(void) {
+    MGEasingCurve curve = {NULL, NULL, MGEasingKindFunction};
+    for (size_t i = 0; i < sizeof(testFunctions) / sizeof(testFunctions[0]); ++i) {
+        mgEasingCurveSetFunction(&curve, testFunctions[i]);
+        CHECK(curve.kind == (i < 7 ? (MGEasingKind) (MGEasingKindLinear + i) : MGEasingKindFunction));
+        CHECK_NEAR(mgEasingCurveProgress(&curve, 0.0), 0.0, 1e-9);
+        CHECK_NEAR(mgEasingCurveProgress(&curve, 1.0), 1.0, 1e-9);
+        testEasingBatchMatchesScalar(&curve);
+    }
+    mgEasingCurveFree(&curve);
+}
+
+static void testEasingCubicBezier(void) {
+    MGEasingCurve curve = {NULL, NULL, MGEasingKindFunction};
+    mgEasingCurveSetCubicBezier(&curve, 0.25, 0.1, 0.25, 1.0);
+    CHECK(curve.table && curve.table[0] == 0.0 && curve.table[MG_EASING_TABLE_SIZE] == 1.0);
+    for (int i = 1; i <= MG_EASING_TABLE_SIZE; ++i) {
+        CHECK(curve.table[i] >= curve.table[i - 1]); /* monotonic control points */
+    }
+    mgEasingCurveSetCubicBezier(&curve, 0.0, 0.0, 1.0, 1.0); /* linear */
+    CHECK_NEAR(mgEasingCurveProgress(&curve, 0.3), 0.3, 1e-3);
+    testEasingBatchMatchesScalar(&curve);
+    mgEasingCurveFree(&curve);
+}
+
+static void testEasingSpring(void) {
+    MGEasingCurve curve = {NULL, NULL, MGEasingKindFunction};
+    mgEasingCurveSetSpring(&curve, 0.5, 0);
+    double maximum = 0;
+    for (int i = 0; i <= MG_EASING_TABLE_SIZE; ++i) {
+        maximum = fmax(maximum, curve.table[i]);
+    }
+    CHECK(maximum > 1.0); /* underdamped overshoots */
+    CHECK(curve.table[MG_EASING_TABLE_SIZE] == 1.0);
+    testEasingBatchMatchesScalar(&curve);
+    mgEasingCurveSetSpring(&curve, 1.0, 0);
+    for (int i = 0; i <= MG_EASING_TABLE_SIZE; ++i) {
+        CHECK(curve.table[i] <= 1.0 + 1e-9); /* critically damped from rest doesn't */
+    }
+    testEasingBatchMatchesScalar(&curve);
+    mgEasingCurveFree(&curve);
+}
+
+static void testEasingCopy(void) {
+    MGEasingCurve curve = {NULL, NULL, MGEasingKindFunction};
+    MGEasingCurve copy = {NULL, NULL, MGEasingKindFunction};
+    mgEasingCurveSetSpring(&curve, 0.5, 0);
+    mgEasingCurveCopy(&copy, &curve);
+    CHECK(copy.table && copy.table != curve.table);
+    CHECK(mgEasingCurveProgress(&copy, 0.4) == mgEasingCurveProgress(&curve, 0.4));
+    mgEasingCurveFree(&curve); /* the copy keeps its table */
+    CHECK_NEAR(mgEasingCurveProgress(&copy, 1.0), 1.0, 1e-9);
+    mgEasingCurveSetFunction(&curve, mgEaseInQuad);
+    mgEasingCurveCopy(&copy, &curve);
+    CHECK(!copy.table && copy.kind == MGEasingKindInQuad && copy.function == mgEaseInQuad);
+    mgEasingCurveFree(&copy);
+}
+
+/* Buttons Layout */
+
+static const MGSwipeLayoutTransition testTransitions[] = {
+    MGSwipeLayoutTransitionBorder, MGSwipeLayoutTransitionStatic, MGSwipeLayoutTransitionDrag,
+    MGSwipeLayoutTransitionClipCenter, MGSwipeLayoutTransitionRotate3D
+};
+
+static void testLayoutInit(MGSwipeButtonsLayout * layout, size_t count, double distance, bool differentWidths) {
+    mgSwipeButtonsLayoutInit(layout, count, distance);
+    for (size_t i = 0; i < count; ++i) {
+        layout->widths[i] = differentWidths ? 40.0 + (i * 37) % 50 : 60.0;
+    }
+    mgSwipeButtonsLayoutUpdateOffsets(layout);
+}
+
+static double testLayoutWidth(const MGSwipeButtonsLayout * layout) {
+    return layout->count ? layout->offsets[layout->count - 1] + layout->widths[layout->count - 1] : 0;
+}
+
+static void testLayoutOffsets(void) {
+    MGSwipeButtonsLayout layout;
+    testLayoutInit(&layout, 3, 5.0, true);
+    CHECK(layout.offsets[0] == 0);
+    CHECK(layout.offsets[1] == layout.widths[0] + 5.0);
+    CHECK(layout.offsets[2] == layout.widths[0] + layout.widths[1] + 10.0);
+    CHECK(isnan(layout.applied[0]) && isnan(layout.applied[2]));
+    mgSwipeButtonsLayoutFree(&layout);
+    CHECK(layout.widths == NULL && layout.count == 0);
+    mgSwipeButtonsLayoutInit(&layout, 0, 5.0);
+    mgSwipeButtonsLayoutUpdateOffsets(&layout);
+    CHECK(mgSwipeButtonsLayoutTransition(&layout, MGSwipeLayoutTransitionBorder, 0.5, 0, true));
+    mgSwipeButtonsLayoutFree(&layout);
+}
+
+static void testLayoutTransitions(void) {
+    MGSwipeButtonsLayout layout;
+    testLayoutInit(&layout, 4, 2.0, true);
+    const double width = testLayoutWidth(&layout);
+    for (int side = 0; side < 2; ++side) {
+        const bool fromLeft = side == 0;
+        /* fully shown: every transition rests at the cached offsets */
+        CHECK(mgSwipeButtonsLayoutTransition(&layout, MGSwipeLayoutTransitionBorder, 1.0, width, fromLeft));
+        for (size_t i = 0; i < layout.count; ++i) {
+            CHECK(layout.positions[i] == layout.offsets[i]);
+        }
+        CHECK(mgSwipeButtonsLayoutTransition(&layout, MGSwipeLayoutTransitionStatic, 1.0, width, fromLeft));
+        for (size_t i = 0; i < layout.count; ++i) {
+            CHECK(layout.positions[i] == layout.offsets[i]);
+        }
+        CHECK(mgSwipeButtonsLayoutTransition(&layout, MGSwipeLayoutTransitionClipCenter, 1.0, width, fromLeft));
+        for (size_t i = 0; i < layout.count; ++i) {
+            CHECK(layout.positions[i] == layout.offsets[i] && layout.clips[i] == 0);
+        }
+        /* hidden: the border transition stacks the buttons on the edge next to the cell content */
+        mgSwipeButtonsLayoutTransition(&layout, MGSwipeLayoutTransitionBorder, 0.0, width, fromLeft);
+        for (size_t i = 0; i < layout.count; ++i) {
+            CHECK(layout.positions[i] == (fromLeft ? width - layout.widths[i] : 0));
+        }
+        mgSwipeButtonsLayoutTransition(&layout, MGSwipeLayoutTransitionStatic, 0.0, width, fromLeft);
+        for (size_t i = 0; i < layout.count; ++i) {
+            CHECK(layout.positions[i] == layout.offsets[i] + (fromLeft ? width : -width));
+        }
+        mgSwipeButtonsLayoutTransition(&layout, MGSwipeLayoutTransitionClipCenter, 0.0, width, fromLeft);
+        for (size_t i = 0; i < layout.count; ++i) {
+            CHECK(layout.clips[i] == round(layout.widths[i] * 0.5));
+        }
+    }
+    CHECK(!mgSwipeButtonsLayoutTransition(&layout, MGSwipeLayoutTransitionDrag, 0.5, width, true));
+    CHECK(!mgSwipeButtonsLayoutTransition(&layout, MGSwipeLayoutTransitionRotate3D, 0.5, width, true));
+    mgSwipeButtonsLayoutFree(&layout);
+}
+
+/** A ranged pass computes the same positions as the full pass */
+static void testLayoutTransitionRange(void) {
+    MGSwipeButtonsLayout layout, full;
+    testLayoutInit(&layout, 9, 3.0, true);
+    testLayoutInit(&full, 9, 3.0, true);
+    const double width = testLayoutWidth(&layout);
+    for (size_t k = 0; k < sizeof(testTransitions) / sizeof(testTransitions[0]); ++k) {
+        if (!mgSwipeButtonsLayoutTransition(&full, testTransitions[k], 0.37, width, true)) {
+            continue;
+        }
+        for (size_t i = 0; i < layout.count; ++i) {
+            CHECK(mgSwipeButtonsLayoutPositionAt(&layout, testTransitions[k], 0.37, width, true, i) == full.positions[i]);
+        }
+        mgSwipeButtonsLayoutTransitionRange(&layout, testTransitions[k], 0.37, width, true, 2, 5);
+        for (size_t i = 2; i < 5; ++i) {
+            CHECK(layout.positions[i] == full.positions[i]);
+        }
+    }
+    mgSwipeButtonsLayoutFree(&layout);
+    mgSwipeButtonsLayoutFree(&full);
+}
+
+/** The visible range matches a brute force scan for every transition, side and window */
+static void testLayoutVisibleRange(void) {
+    for (int widths = 0; widths < 2; ++widths) {
+        MGSwipeButtonsLayout layout;
+        testLayoutInit(&layout, 40, 4.0, widths == 1);
+        const double width = testLayoutWidth(&layout);
+        int mismatches = 0;
+        for (size_t k = 0; k < sizeof(testTransitions) / sizeof(testTransitions[0]); ++k) {
+            for (int side = 0; side < 2; ++side) {
+                for (int step = 0; step <= 10; ++step) {
+                    const double t = step / 10.0;
+                    for (double visibleMin = -width; visibleMin < width; visibleMin += width / 7) {
+                        const double visibleMax = visibleMin + 200;
+                        size_t first, end;
+                        mgSwipeButtonsLayoutVisibleRange(&layout, testTransitions[k], t, width, side == 0, visibleMin, visibleMax, &first, &end);
+                        for (size_t i = 0; i < layout.count; ++i) {
+                            const bool visible = mgSwipeButtonsLayoutIsVisible(&layout, testTransitions[k], t, width, side == 0, visibleMin, visibleMax, i);
+                            /* the range includes hidden buttons only for the 3D transition or between overlapping buttons */
+                            const bool inRange = i >= first && i < end;
+                            const bool exact = widths == 0 && testTransitions[k] != MGSwipeLayoutTransitionRotate3D;
+                            if (visible ? !inRange : inRange && exact) {
+                                mismatches++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        CHECK(mismatches == 0);
+        mgSwipeButtonsLayoutFree(&layout);
+    }
+}
+
+/* Metrics Ring Buffer */
+
+static void testMetricsRing(void) {
+    MGSwipeMetricsRing ring;
+    mgSwipeMetricsRingInit(&ring, 5); /* rounded up to 8 */
+    CHECK(ring.mask == 7);
+    for (int i = 0; i < 10; ++i) {
+        CHECK(mgSwipeMetricsRingPush(&ring, i % 3, i) == (i < 8));
+    }
+    CHECK(atomic_load(&ring.dropped) == 2);
+    MGSwipeMetricSample samples[8];
+    CHECK(mgSwipeMetricsRingPop(&ring, samples, 3) == 3);
+    CHECK(samples[0].metric == 0 && samples[2].value == 2.0);
+    CHECK(mgSwipeMetricsRingPush(&ring, 1, 42.0)); /* space released by the pop */
+    CHECK(mgSwipeMetricsRingPop(&ring, samples, 8) == 6);
+    CHECK(samples[5].value == 42.0);
+    CHECK(mgSwipeMetricsRingPop(&ring, samples, 8) == 0);
+    MGSwipeMetricAggregate aggregate = {0, 0, 0};
+    mgSwipeMetricAggregateAdd(&aggregate, -3.0);
+    mgSwipeMetricAggregateAdd(&aggregate, -1.0);
+    CHECK(aggregate.count == 2 && aggregate.total == -4.0 && aggregate.maximum == -1.0);
+    mgSwipeMetricsRingFree(&ring);
+}
+
+/* Spring Physics */
+
+static void testSpringStopsAtTarget(void) {
+    //closing from 100 faster than omega * 100 overshoots 0 with the plain step
+    MGSpring spring;
+    mgSpringInit(&spring, 100, -5000, 0, 0.5);
+    double minimum = spring.position;
+    for (int i = 0; i < 60; ++i) {
+        mgSpringStep(&spring, 1.0 / 60.0);
+        minimum = fmin(minimum, spring.position);
+    }
+    CHECK(minimum < 0);
+
+    mgSpringInit(&spring, 100, -5000, 0, 0.5);
+    for (int i = 0; i < 60; ++i) {
+        mgSpringStepToTarget(&spring, 1.0 / 60.0);
+        CHECK(spring.position >= 0);
+    }
+    CHECK(mgSpringIsSettled(&spring));
+    CHECK(mgSpringSettleTime(spring, 1.0 / 60.0, 2.0) == 0);
+
+    //a slow approach isn't affected
+    mgSpringInit(&spring, -100, 0, 0, 0.5);
+    MGSpring plain = spring;
+    for (int i = 0; i < 30; ++i) {
+        mgSpringStepToTarget(&spring, 1.0 / 60.0);
+        mgSpringStep(&plain, 1.0 / 60.0);
+        CHECK(spring.position == plain.position);
+    }
+}
+
+/* Animation Ticker */
+
+typedef struct TestClient {
+    MGAnimationTicker * ticker;
+    int ticks;
+    int releases;
+    double timestamp;
+    int removeAtTick; /* removes itself on this tick, 0 never */
+    struct TestClient * removeOther; /* removed by this client on its first tick */
+    struct TestClient * addOther; /* added by this client on its first tick */
+    struct TestClient * releaseOther; /* removed by this client when it's released */
+} TestClient;
+
+static void testTick(void * client, double timestamp) {
+    TestClient * test = (TestClient *) client;
+    test->ticks++;
+    test->timestamp = timestamp;
+    if (test->ticks == test->removeAtTick) {
+        CHECK(mgAnimationTickerRemove(test->ticker, test));
+    }
+    if (test->ticks == 1 && test->removeOther) {
+        CHECK(mgAnimationTickerRemove(test->ticker, test->removeOther));
+    }
+    if (test->ticks == 1 && test->addOther) {
+        CHECK(mgAnimationTickerAdd(test->ticker, test->addOther));
+    }
+}
+
+static void testRelease(void * client) {
+    TestClient * test = (TestClient *) client;
+    test->releases++;
+    if (test->releaseOther) {
+        CHECK(mgAnimationTickerRemove(test->ticker, test->releaseOther));
+    }
+}
+
+static void testTickerAddRemove(void) {
+    MGAnimationTicker ticker;
+    mgAnimationTickerInit(&ticker, testTick, testRelease);
+    TestClient a = {&ticker, 0, 0, 0, 0, NULL, NULL, NULL}, b = a;
+    CHECK(mgAnimationTickerAdd(&ticker, &a));
+    CHECK(mgAnimationTickerAdd(&ticker, &b));
+    CHECK(ticker.active == 2);
+    mgAnimationTickerAdvance(&ticker, 1.0);
+    CHECK(a.ticks == 1 && b.ticks == 1);
+    CHECK(a.timestamp == 1.0);
+    CHECK(mgAnimationTickerRemove(&ticker, &a));
+    CHECK(a.releases == 1);
+    CHECK(!mgAnimationTickerRemove(&ticker, &a));
+    CHECK(ticker.active == 1 && ticker.count == 1);
+    mgAnimationTickerAdvance(&ticker, 2.0);
+    CHECK(a.ticks == 1 && b.ticks == 2);
+    mgAnimationTickerFree(&ticker);
+    CHECK(b.releases == 1);
+}
+
+static void testTickerFrameRateRange(void) {
+    MGAnimationTicker ticker;
+    mgAnimationTickerInit(&ticker, testTick, testRelease);
+    TestClient a = {&ticker, 0, 0, 0, 0, NULL, NULL, NULL}, b = a, c = a;
+    const MGFrameRateRange fast = {80, 120, 120}, slow = {0, 60, 60};
+    CHECK(mgAnimationTickerAdd(&ticker, &a));
+    CHECK(!ticker.rangeChanged); /* no preference */
+    CHECK(mgAnimationTickerAdd(&ticker, &b));
+    CHECK(mgAnimationTickerSetFrameRateRange(&ticker, &b, fast, true));
+    CHECK(mgAnimationTickerAdd(&ticker, &c));
+    CHECK(mgAnimationTickerSetFrameRateRange(&ticker, &c, slow, false));
+    CHECK(!mgAnimationTickerSetFrameRateRange(&ticker, &ticker, slow, false));
+    CHECK(ticker.rangeChanged);
+    MGFrameRateRange range = mgAnimationTickerFrameRateRange(&ticker, false, MGThermalStateNominal);
+    CHECK(!ticker.rangeChanged);
+    CHECK(range.minimum == 80 && range.maximum == 120 && range.preferred == 120);
+    /* only the adapting client is downshifted */
+    range = mgAnimationTickerFrameRateRange(&ticker, true, MGThermalStateNominal);
+    CHECK(range.minimum == 60 && range.maximum == 60 && range.preferred == 60);
+    CHECK(mgAnimationTickerSetFrameRateRange(&ticker, &b, fast, true));
+    CHECK(!ticker.rangeChanged); /* unchanged */
+    CHECK(mgAnimationTickerRemove(&ticker, &a));
+    CHECK(!ticker.rangeChanged);
+    CHECK(mgAnimationTickerRemove(&ticker, &b));
+    CHECK(ticker.rangeChanged);
+    range = mgAnimationTickerFrameRateRange(&ticker, false, MGThermalStateNominal);
+    CHECK(range.minimum == 0 && range.maximum == 60 && range.preferred == 60);
+    CHECK(mgAnimationTickerRemove(&ticker, &c));
+    range = mgAnimationTickerFrameRateRange(&ticker, false, MGThermalStateNominal);
+    CHECK(mgFrameRateRangeIsDefault(range));
+    mgAnimationTickerFree(&ticker);
+}
+
+static void testTickerRemoveWhileTicking(void) {
+    MGAnimationTicker ticker;
+    mgAnimationTickerInit(&ticker, testTick, testRelease);
+    TestClient a = {&ticker, 0, 0, 0, 2, NULL, NULL, NULL}, b = {&ticker, 0, 0, 0, 0, NULL, NULL, NULL}, c = b;
+    b.removeOther = &c; /* c is after b, it must not be ticked once removed */
+    mgAnimationTickerAdd(&ticker, &a);
+    mgAnimationTickerAdd(&ticker, &b);
+    mgAnimationTickerAdd(&ticker, &c);
+    CHECK(mgAnimationTickerAdvance(&ticker, 1.0));
+    CHECK(c.ticks == 0 && c.releases == 1);
+    CHECK(a.releases == 0);
+    CHECK(mgAnimationTickerAdvance(&ticker, 2.0));
+    CHECK(a.ticks == 2 && a.releases == 1);
+    CHECK(!mgAnimationTickerAdvance(&ticker, 3.0));
+    CHECK(a.ticks == 2);
+    CHECK(b.ticks == 3 && ticker.active == 1 && ticker.count == 1);
+    mgAnimationTickerFree(&ticker);
+}
+
+static void testTickerAddWhileTicking(void) {
+    MGAnimationTicker ticker;
+    mgAnimationTickerInit(&ticker, testTick, testRelease);
+    TestClient added = {&ticker, 0, 0, 0, 0, NULL, NULL, NULL};
+    TestClient clients[16];
+    for (int i = 0; i < 16; ++i) { /* fills the initial storage, adding during the tick grows it */
+        clients[i] = added;
+        mgAnimationTickerAdd(&ticker, &clients[i]);
+    }
+    clients[0].addOther = &added;
+    mgAnimationTickerAdvance(&ticker, 1.0);
+    CHECK(added.ticks == 0); /* starts on the next tick */
+    CHECK(clients[15].ticks == 1);
+    mgAnimationTickerAdvance(&ticker, 2.0);
+    CHECK(added.ticks == 1);
+    CHECK(ticker.active == 17);
+    mgAnimationTickerFree(&ticker);
+    CHECK(added.releases == 1 && clients[15].releases == 1);
+}
+
+static void testTickerRemoveFromRelease(void) {
+    MGAnimationTicker ticker;
+    mgAnimationTickerInit(&ticker, testTick, testRelease);
+    TestClient a = {&ticker, 0, 0, 0, 1, NULL, NULL, NULL}, b = {&ticker, 0, 0, 0, 0, NULL, NULL, NULL}, c = b;
+    a.releaseOther = &c; /* like a client whose dealloc stops another animation */
+    mgAnimationTickerAdd(&ticker, &a);
+    mgAnimationTickerAdd(&ticker, &b);
+    mgAnimationTickerAdd(&ticker, &c);
+    mgAnimationTickerAdvance(&ticker, 1.0);
+    CHECK(a.releases == 1 && c.releases == 1 && b.releases == 0);
+    CHECK(ticker.active == 1 && ticker.count == 1 && ticker.entries[0].client == &b);
+    CHECK(!ticker.ticking);
+    mgAnimationTickerFree(&ticker);
+}
+
+int main(void) {
+    RUN(testEasingFunctions);
+    RUN(testEasingCubicBezier);
+    RUN(testEasingSpring);
+    RUN(testEasingCopy);
+    RUN(testLayoutOffsets);
+    RUN(testLayoutTransitions);
+    RUN(testLayoutTransitionRange);
+    RUN(testLayoutVisibleRange);
+    RUN(testMetricsRing);
+    RUN(testSpringStopsAtTarget);
+    RUN(testTickerAddRemove);
+    RUN(testTickerRemoveWhileTicking);
+    RUN(testTickerAddWhileTicking);
+    RUN(testTickerRemoveFromRelease);
+    RUN(testTickerFrameRateRange);
+    return mgTestFailures ? 1 : 0;
+}